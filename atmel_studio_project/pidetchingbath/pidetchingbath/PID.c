@@ -25,8 +25,52 @@ SOFTWARE.
 #include "PID.h"
 #include "my_util.h"
 #include "config.h"
+#include <math.h>
 
-void pid_init(pid_state_t* state, float pid_Kp, float pid_Ti, float pid_Td, float pid_i_clamp, float pid_offset, float smoothing_factor, float control_min, float control_max)
+#define PID_BIQUAD_COEFF_SHIFT 28
+#define PID_BIQUAD_SIGNAL_SHIFT 16
+// input limit in K/s. Leaves headroom for the resonance peak of high q filters in the Q16 output.
+#define PID_BIQUAD_MAX_INPUT 4095.0
+
+static void pid_biquad_set_params(pid_biquad_t* filter, float cutoff, float q)
+{
+	// low pass from the audio eq cookbook, normalized to a0 = 1
+	float w0 = 2.0 * M_PI * fmin(cutoff, 0.45 / PID_DELTA_T) * PID_DELTA_T;
+	float cos_w0 = cos(w0);
+	float alpha = sin(w0) / (2.0 * fmax(q, 0.1));
+	float a0 = 1.0 + alpha;
+	filter->b0 = (int32_t)lround((1.0 - cos_w0) / (2.0 * a0) * (1L << PID_BIQUAD_COEFF_SHIFT));
+	filter->a1 = (int32_t)lround(-2.0 * cos_w0 / a0 * (1L << PID_BIQUAD_COEFF_SHIFT));
+	filter->a2 = (int32_t)lround((1.0 - alpha) / a0 * (1L << PID_BIQUAD_COEFF_SHIFT));
+}
+
+static void pid_biquad_reset(pid_biquad_t* filter)
+{
+	filter->x1 = 0;
+	filter->x2 = 0;
+	filter->y1 = 0;
+	filter->y2 = 0;
+	filter->error = 0;
+}
+
+static float pid_biquad_step(pid_biquad_t* filter, float input)
+{
+	int32_t x0 = (int32_t)(fmax(fmin(input, PID_BIQUAD_MAX_INPUT), -PID_BIQUAD_MAX_INPUT) * (1L << PID_BIQUAD_SIGNAL_SHIFT));
+	// symmetric numerator needs only one multiplication
+	int64_t acc = (int64_t)filter->b0 * ((int64_t)x0 + 2 * (int64_t)filter->x1 + filter->x2);
+	acc -= (int64_t)filter->a1 * filter->y1;
+	acc -= (int64_t)filter->a2 * filter->y2;
+	acc += filter->error;
+	int32_t y0 = (int32_t)(acc >> PID_BIQUAD_COEFF_SHIFT);
+	filter->error = (int32_t)(acc - ((int64_t)y0 << PID_BIQUAD_COEFF_SHIFT));
+	filter->x2 = filter->x1;
+	filter->x1 = x0;
+	filter->y2 = filter->y1;
+	filter->y1 = y0;
+	return (float)y0 / (1L << PID_BIQUAD_SIGNAL_SHIFT);
+}
+
+void pid_init(pid_state_t* state, float pid_Kp, float pid_Ti, float pid_Td, float pid_i_clamp, float pid_offset, float d_filter_cutoff, float d_filter_q, float sp_weight_p, float sp_weight_d, float sp_filter_tc, float control_min, float control_max)
 {
 	state->Kp = pid_Kp;
 	state->Ti = pid_Ti;
@@ -35,15 +79,27 @@ void pid_init(pid_state_t* state, float pid_Kp, float pid_Ti, float pid_Td, floa
 	state->control_max = control_max;
 	state->control_min = control_min;
 	state->offset = pid_offset;
-	state->smoothing_factor = smoothing_factor;
+	state->d_filter_cutoff = d_filter_cutoff;
+	state->d_filter_q = d_filter_q;
+	state->sp_weight_p = sp_weight_p;
+	state->sp_weight_d = sp_weight_d;
+	state->sp_filter_tc = sp_filter_tc;
+	state->feedforward = 0.0;
+	pid_biquad_set_params(&state->d_filter, d_filter_cutoff, d_filter_q);
 	
 	state->old_process_value = 0.0;
+	state->old_set_value = 0.0;
+	state->filtered_set_value = 0.0;
+	state->weighted_set_value_base = 0.0;
+	state->set_value_valid = FALSE;
 	state->integrator = 0.0;
-	state->smd1 = 0.0;
-	state->smd2 = 0.0;
+	state->integrator_from_output = FALSE;
+	state->velocity_form = FALSE;
+	state->output = 0.0;
+	pid_biquad_reset(&state->d_filter);
 }
 
-void pid_set_params(pid_state_t* state, float pid_Kp, float pid_Ti, float pid_Td, float pid_i_clamp, float pid_offset, float smoothing_factor, float control_min, float control_max)
+void pid_set_params(pid_state_t* state, float pid_Kp, float pid_Ti, float pid_Td, float pid_i_clamp, float pid_offset, float d_filter_cutoff, float d_filter_q, float sp_weight_p, float sp_weight_d, float sp_filter_tc, float control_min, float control_max)
 {
 	state->Kp = pid_Kp;
 	state->Ti = pid_Ti;
@@ -52,37 +108,134 @@ void pid_set_params(pid_state_t* state, float pid_Kp, float pid_Ti, float pid_Td
 	state->control_max = control_max;
 	state->control_min = control_min;
 	state->offset = pid_offset;
-	state->smoothing_factor = smoothing_factor;
+	state->sp_weight_p = sp_weight_p;
+	state->sp_weight_d = sp_weight_d;
+	state->sp_filter_tc = sp_filter_tc;
+	// filter coefficients are only recalculated if the filter changed, this is called from the control loop as well
+	if(d_filter_cutoff != state->d_filter_cutoff || d_filter_q != state->d_filter_q)
+	{
+		state->d_filter_cutoff = d_filter_cutoff;
+		state->d_filter_q = d_filter_q;
+		pid_biquad_set_params(&state->d_filter, d_filter_cutoff, d_filter_q);
+	}
+}
+
+void pid_set_feedforward(pid_state_t* state, float feedforward)
+{
+	state->feedforward = feedforward;
+}
+
+void pid_set_velocity_form(pid_state_t* state, uint8_t velocity_form)
+{
+	// the positional form continues from the last velocity form output by back calculating its integrator
+	if(state->velocity_form && !velocity_form)
+		state->integrator_from_output = TRUE;
+	state->velocity_form = velocity_form;
 }
 
 float pid_step(pid_state_t* state, float process_value, float set_value)
 {
+	// set point prefilter (first order low pass). Starts at the process value after a reset, so the set point is approached smoothly.
+	uint8_t first_step = !state->set_value_valid;
+	if(first_step)
+	{
+		state->filtered_set_value = process_value;
+		state->old_set_value = process_value;
+		state->old_process_value = process_value; // no derivative kick from the reset value
+		state->weighted_set_value_base = process_value;
+		state->set_value_valid = TRUE;
+	}
+	state->filtered_set_value += (set_value - state->filtered_set_value) * (PID_DELTA_T / (state->sp_filter_tc + PID_DELTA_T));
+	set_value = state->filtered_set_value;
 	// error
 	float error = set_value - process_value;
-	// proportional term
-	float output = state->offset + state->Kp * error;
-	// derivative term (instead of de/dt use -dPV/dt to get rid of set point spikes)
-	float dPV_dt = ((process_value - state->old_process_value) / PID_DELTA_T);
-	// second order exponential smoothing
-	state->smd1 = (1.0 - state->smoothing_factor) * dPV_dt + state->smoothing_factor * state->smd1;
-	state->smd2 = (1.0 - state->smoothing_factor) * state->smd1 + (1.0 - state->smoothing_factor) * state->smd2;
-	// calculate d term contribution
-	output -= state->Kp * state->Td * state->smd2;
+	// proportional term on b * SP - PV (b < 1 reduces the proportional kick on set point changes).
+	// SP is an absolute temperature here, so b only weights the set point change relative to a base which follows the set point with Ti.
+	// Otherwise the integrator would have to hold a (b - 1) * Kp * SP bias which is far outside of the control range.
+	state->weighted_set_value_base += (set_value - state->weighted_set_value_base) * (PID_DELTA_T / (state->Ti + PID_DELTA_T));
+	float p_error = state->weighted_set_value_base + state->sp_weight_p * (set_value - state->weighted_set_value_base) - process_value;
+	// derivative term on c * SP - PV (c = 0 is derivative on measurement, no set point spikes)
+	float dE_dt = ((state->sp_weight_d * (set_value - state->old_set_value) - (process_value - state->old_process_value)) / PID_DELTA_T);
+	// second order low pass, unity gain at dc
+	float dE_dt_filtered = pid_biquad_step(&state->d_filter, dE_dt);
 	state->old_process_value = process_value;
-	// integral term
-	// integrate and clamp error signal; dynamic clamping! (and additionally scale the usable integrator range with i_clamp e[0, 1] to reduce the integrator overshoot for large delays)
-	float i_max = fmax(state->control_max - output, 0.0) * state->i_clamp;
-	float i_min = fmin(state->control_min - output, 0.0) * state->i_clamp;
-	state->integrator = fmax(fmin(state->integrator + (state->Kp / fmax(state->Ti, 1.0 / F_CPU)) * error * PID_DELTA_T, i_max), i_min);
-	output += state->integrator; // = p + i + d
+	state->old_set_value = set_value;
+	// feedforward provides the holding output, so the integrator only has to handle the residual error
+	float bias = state->offset + state->feedforward;
+	// integral term (always on the full error, so the set point is reached regardless of the weights)
+	float i_step = (state->Kp / fmax(state->Ti, 1.0 / F_CPU)) * error * PID_DELTA_T;
+	float output;
+	if(state->velocity_form && !first_step)
+	{
+		// velocity form: only the changes of the terms are added to the last output. Gains act on differences, so parameter changes are bumpless.
+		// Clamping the accumulated output is the anti windup.
+		output = state->output + bias - state->old_bias + state->Kp * (p_error - state->old_p_error) + state->Kp * state->Td * (dE_dt_filtered - state->old_d_error) + i_step;
+	}
+	else
+	{
+		output = bias + state->Kp * p_error + state->Kp * state->Td * dE_dt_filtered; // = p + d
+		// continue from the last output after a change of the algorithm
+		if(state->integrator_from_output)
+		{
+			state->integrator = state->output - output;
+			state->integrator_from_output = FALSE;
+		}
+		// integrate and clamp error signal; dynamic clamping! (and additionally scale the usable integrator range with i_clamp e[0, 1] to reduce the integrator overshoot for large delays)
+		float i_max = fmax(state->control_max - output, 0.0) * state->i_clamp;
+		float i_min = fmin(state->control_min - output, 0.0) * state->i_clamp;
+		state->integrator = fmax(fmin(state->integrator + i_step, i_max), i_min);
+		output += state->integrator; // = p + i + d
+	}
+	state->old_p_error = p_error;
+	state->old_d_error = dE_dt_filtered;
+	state->old_bias = bias;
 	// clamp to control signal range and return
-	return fmax(fmin(output, state->control_max), state->control_min);	
+	state->output = fmax(fmin(output, state->control_max), state->control_min);
+	return state->output;
+}
+
+void pid_track(pid_state_t* state, float process_value, float output)
+{
+	// the controller is in manual mode, follow the plant so the next pid_step continues bumplessly from output.
+	// The filtered set point starts at the process value, so there is no error at the transfer and the integrator holds output - bias.
+	// The way to the actual set point is a regular set point change (weighted and prefiltered).
+	state->filtered_set_value = process_value;
+	state->old_set_value = process_value;
+	state->weighted_set_value_base = process_value;
+	state->old_process_value = process_value;
+	state->set_value_valid = TRUE;
+	pid_biquad_reset(&state->d_filter);
+	state->old_p_error = 0.0;
+	state->old_d_error = 0.0;
+	state->old_bias = state->offset + state->feedforward;
+	state->output = fmax(fmin(output, state->control_max), state->control_min);
+	state->integrator = state->output - state->old_bias;
+	state->integrator_from_output = FALSE;
 }
 
 void pid_reset(pid_state_t* state)
 {
 	state->old_process_value = 0.0;
+	state->set_value_valid = FALSE;
 	state->integrator = 0.0;
-	state->smd1 = 0.0;
-	state->smd2 = 0.0;
+	state->integrator_from_output = FALSE;
+	state->output = 0.0;
+	pid_biquad_reset(&state->d_filter);
+}
+
+void pid_interpolate_gains(const pid_gains_t* table, uint8_t num_entries, float first_set_value, float set_value_step, float set_value, pid_gains_t* gains)
+{
+	// table entries are equidistant set values starting at first_set_value. Outside of the table the outermost entries are used.
+	float pos = fmax(fmin((set_value - first_set_value) / set_value_step, (float)(num_entries - 1)), 0.0);
+	uint8_t i = (uint8_t)pos;
+	if(i >= num_entries - 1)
+	{
+		*gains = table[num_entries - 1];
+		return;
+	}
+	// linear interpolation between the two neighboring entries
+	float t = pos - i;
+	gains->Kp = table[i].Kp + t * (table[i + 1].Kp - table[i].Kp);
+	gains->Ti = table[i].Ti + t * (table[i + 1].Ti - table[i].Ti);
+	gains->Td = table[i].Td + t * (table[i + 1].Td - table[i].Td);
 }
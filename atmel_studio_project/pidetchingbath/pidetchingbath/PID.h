@@ -26,25 +26,64 @@ SOFTWARE.
 #define PID_H_
 #include <stdint.h>
 
+typedef struct
+{
+	float Kp;
+	float Ti;
+	float Td;
+} pid_gains_t;
+
+// second order low pass (biquad, direct form I) in fixed point.
+// Coefficients are Q28, signal values Q16.
+typedef struct
+{
+	int32_t b0;			// b1 = 2 * b0, b2 = b0 for a low pass
+	int32_t a1;
+	int32_t a2;
+	int32_t x1;
+	int32_t x2;
+	int32_t y1;
+	int32_t y2;
+	int32_t error;		// truncation error of the last output, fed back to avoid a dead band at low cutoff frequencies
+} pid_biquad_t;
+
 typedef struct
 {
 	float old_process_value;
+	float old_set_value;
+	float filtered_set_value;
+	float weighted_set_value_base;
+	uint8_t set_value_valid;
 	float integrator;
-	float smd1;
-	float smd2;
+	uint8_t integrator_from_output;	// back calculate the integrator from the last output in the next positional step
+	float output;			// last output, accumulator of the velocity form
+	float old_p_error;		// proportional error, derivative and bias of the last step for the velocity form
+	float old_d_error;
+	float old_bias;
+	uint8_t velocity_form;	// incremental algorithm instead of the positional one
+	pid_biquad_t d_filter;	// derivative low pass
 	float Kp;
 	float Ti;
 	float Td;
 	float i_clamp;
 	float offset;
-	float smoothing_factor;
+	float feedforward;
+	float d_filter_cutoff;	// derivative low pass cutoff frequency in Hz
+	float d_filter_q;		// derivative low pass quality factor, 0.707 is maximally flat
+	float sp_weight_p;		// set point weight b of the proportional term
+	float sp_weight_d;		// set point weight c of the derivative term
+	float sp_filter_tc;		// time constant of the set point prefilter in seconds, 0 disables the filter
 	float control_min;
 	float control_max;
 } pid_state_t;
 
-void pid_init(pid_state_t* state, float pid_Kp, float pid_Ti, float pid_Td, float pid_i_clamp, float pid_offset, float smoothing_factor, float control_min, float control_max);
-void pid_set_params(pid_state_t* state, float pid_Kp, float pid_Ti, float pid_Td, float pid_i_clamp, float pid_offset, float smoothing_factor, float control_min, float control_max);
+void pid_init(pid_state_t* state, float pid_Kp, float pid_Ti, float pid_Td, float pid_i_clamp, float pid_offset, float d_filter_cutoff, float d_filter_q, float sp_weight_p, float sp_weight_d, float sp_filter_tc, float control_min, float control_max);
+void pid_set_params(pid_state_t* state, float pid_Kp, float pid_Ti, float pid_Td, float pid_i_clamp, float pid_offset, float d_filter_cutoff, float d_filter_q, float sp_weight_p, float sp_weight_d, float sp_filter_tc, float control_min, float control_max);
+void pid_set_feedforward(pid_state_t* state, float feedforward);
+void pid_set_velocity_form(pid_state_t* state, uint8_t velocity_form);
 float pid_step(pid_state_t* state, float process_value, float set_value);
+void pid_track(pid_state_t* state, float process_value, float output);
 void pid_reset(pid_state_t* state);
+void pid_interpolate_gains(const pid_gains_t* table, uint8_t num_entries, float first_set_value, float set_value_step, float set_value, pid_gains_t* gains);
 
 #endif /* PID_H_ */
\ No newline at end of file
@@ -0,0 +1,99 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#include "agitation.h"
+#include <avr/pgmspace.h>
+
+// one period of (1 + sin) / 2, 64 entries
+static const uint8_t agt_sine_table[64] PROGMEM = {
+	128, 140, 152, 165, 176, 188, 198, 208, 218, 226, 234, 240, 245, 250, 253, 254,
+	255, 254, 253, 250, 245, 240, 234, 226, 218, 208, 198, 188, 176, 165, 152, 140,
+	128, 115, 103, 90, 79, 67, 57, 47, 37, 29, 21, 15, 10, 5, 2, 1,
+	0, 1, 2, 5, 10, 15, 21, 29, 37, 47, 57, 67, 79, 90, 103, 115
+};
+
+void agt_init(agt_state_t* state, uint8_t waveform, float period, uint8_t depth)
+{
+	state->duty_cycle = 0;
+	state->phase = 0;
+	state->output = 0;
+	agt_set_params(state, waveform, period, depth);
+}
+
+void agt_set_params(agt_state_t* state, uint8_t waveform, float period, uint8_t depth)
+{
+	state->waveform = waveform;
+	state->depth = depth;
+	state->phase_step = (uint16_t)(65536.0 * APP_AGITATION_UPDATE_INTERVAL / period + 0.5);
+}
+
+void agt_set_duty_cycle(agt_state_t* state, uint8_t duty_cycle)
+{
+	// restart the waveform at the beginning of a period if the stirrer stands still
+	if(!agt_active(state))
+		state->phase = 0;
+	state->duty_cycle = duty_cycle;
+}
+
+uint8_t agt_update(agt_state_t* state)
+{
+	// waveform value 0..255
+	uint8_t wave;
+	switch(state->waveform)
+	{
+		case AGT_WAVE_BURST:
+			wave = (state->phase < 0x8000) ? 255 : 0;
+			break;
+		case AGT_WAVE_RAMP:
+			wave = (uint8_t)(state->phase >> 8);
+			break;
+		case AGT_WAVE_SINE:
+			wave = pgm_read_byte(&agt_sine_table[state->phase >> 10]);
+			break;
+		default: // AGT_WAVE_CONSTANT
+			wave = 255;
+			break;
+	}
+	state->phase += state->phase_step;
+	
+	// target = duty cycle * (1 - depth * (1 - wave))
+	uint16_t modulation = 25500 - (uint16_t)state->depth * (255 - wave);
+	int16_t target = (int16_t)(((uint32_t)state->duty_cycle * 128 * modulation) / 25500);
+	
+	// soft start / stop and soft burst edges. A sudden speed change decouples the stir bar from the magnet.
+	if(target > state->output + AGT_SLEW_STEP)
+		state->output += AGT_SLEW_STEP;
+	else if(target < state->output - AGT_SLEW_STEP)
+		state->output -= AGT_SLEW_STEP;
+	else
+		state->output = target;
+	
+	return (uint8_t)((state->output + 64) >> 7);
+}
+
+uint8_t agt_active(agt_state_t* state)
+{
+	return state->duty_cycle > 0 || state->output > 0;
+}
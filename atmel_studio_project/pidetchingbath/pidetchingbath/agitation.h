@@ -0,0 +1,56 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef AGITATION_H_
+#define AGITATION_H_
+#include <stdint.h>
+#include "config.h"
+
+// agitation waveforms. The stirrer duty cycle is modulated between (100 - depth)% and 100% of the set duty cycle.
+#define AGT_WAVE_CONSTANT 0	// plain duty cycle
+#define AGT_WAVE_BURST 1	// square wave, full speed for the first half of the period
+#define AGT_WAVE_RAMP 2		// sawtooth, speed rises over the period and drops at its end
+#define AGT_WAVE_SINE 3
+#define AGT_NUM_WAVES 4
+
+typedef struct
+{
+	uint8_t waveform;
+	uint8_t depth;			// modulation depth in % of the duty cycle
+	uint8_t duty_cycle;		// set duty cycle, peak of the waveform
+	uint16_t phase;			// one period = 65536
+	uint16_t phase_step;	// phase increment per update
+	int16_t output;			// slew rate limited duty cycle in 1/128 %
+} agt_state_t;
+
+void agt_init(agt_state_t* state, uint8_t waveform, float period, uint8_t depth);
+void agt_set_params(agt_state_t* state, uint8_t waveform, float period, uint8_t depth);
+void agt_set_duty_cycle(agt_state_t* state, uint8_t duty_cycle);
+// advances the waveform by one update interval, returns the duty cycle for the stirrer
+uint8_t agt_update(agt_state_t* state);
+// TRUE while the stirrer is running or still spinning down
+uint8_t agt_active(agt_state_t* state);
+
+#endif /* AGITATION_H_ */
@@ -215,6 +215,17 @@ appt_cycle_t appt_get_cycles_since_startup()
 	return appt_cycles_old;
 }
 
+appt_cycle_t appt_get_current_cycles()
+{
+	// live counter instead of the value of the last update, e.g. for timestamps taken in interrupts
+	appt_cycle_t cycles;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		cycles = appt_cycles;
+	}
+	return cycles;
+}
+
 void appt_set_callback(float interval, appt_callback func, uint8_t index)
 {
 	assert(index < APP_TIMER_MAX_CALLBACKS);
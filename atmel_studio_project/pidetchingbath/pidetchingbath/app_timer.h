@@ -69,6 +69,7 @@ float			appt_get_seconds_since_startup();
 float			appt_get_milli_seconds_since_startup();
 float			appt_get_micro_seconds_since_startup();
 appt_cycle_t	appt_get_cycles_since_startup();
+appt_cycle_t	appt_get_current_cycles();
 void			appt_set_callback(float interval, appt_callback func, uint8_t index);
 void			appt_clear_callback(uint8_t index);
 appt_cycle_t	appt_seconds_to_cycles(float seconds);
@@ -22,14 +22,34 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
  */ 
 
+#include <math.h>
 #include "application.h"
 
-// persistent state
-eeprom_settings_t app_eeprom_settings EEMEM;
+// persistent state, the blocks have to fit their slots of the eeprom layout
+_Static_assert(sizeof(eeprom_settings_t) <= APP_EEPROM_LEARNED_SLOT - APP_EEPROM_SETTINGS_SLOT, "settings exceed their eeprom slot");
+_Static_assert(sizeof(eeprom_learned_t) <= APP_EEPROM_STATS_SLOT - APP_EEPROM_LEARNED_SLOT, "learned values exceed their eeprom slot");
+_Static_assert(sizeof(eeprom_stats_t) <= APP_EEPROM_RECIPE_SLOT - APP_EEPROM_STATS_SLOT, "stats exceed their eeprom slot");
+_Static_assert(sizeof(eeprom_recipe_t) <= APP_EEPROM_END - APP_EEPROM_RECIPE_SLOT, "recipe exceeds its eeprom slot");
+_Static_assert(APP_EEPROM_END <= E2END + 1, "eeprom layout exceeds the eeprom");
 
 // application state
 app_state_t app_state;
 
+// error policies by error code. Probe faults of the controlling, safety or an active zone probe use the first policy, faults of the other probes the second one.
+static const app_error_policy_t app_error_policies[][2] = {
+	{ { APP_EP_RECOVER, 0 },									{ APP_EP_RECOVER, 0 } },									// EC_SUCCESS
+	{ { APP_EP_RECOVER, APP_FAULT_RECOVER_TICKS },				{ APP_EP_LOG, 0 } },										// EC_THERMISTOR_OPEN_CIRCUIT
+	{ { APP_EP_RECOVER, APP_FAULT_RECOVER_TICKS },				{ APP_EP_LOG, 0 } },										// EC_THERMISTOR_SHORT_CIRCUIT
+	{ { APP_EP_LATCH, 0 },										{ APP_EP_LATCH, 0 } },										// EC_THERMISTOR_NOT_RESPONDING
+	{ { APP_EP_LATCH, 0 },										{ APP_EP_LATCH, 0 } },										// EC_NO_CONTROLLING_TPROBE
+	{ { APP_EP_LATCH, 0 },										{ APP_EP_LOG, 0 } },										// EC_THERMISTOR_MAX_TEMP
+	{ { APP_EP_RECOVER, APP_FAULT_RECOVER_TICKS },				{ APP_EP_LOG, 0 } },										// EC_THERMISTOR_MIN_TEMP
+	{ { APP_EP_LATCH, 0 },										{ APP_EP_LATCH, 0 } },										// EC_FAN_STALL
+	{ { APP_EP_RECOVER, APP_FAULT_RECOVER_TICKS_IMPLAUSIBLE },	{ APP_EP_LOG, 0 } },										// EC_THERMISTOR_IMPLAUSIBLE
+	{ { APP_EP_LATCH, 0 },										{ APP_EP_LATCH, 0 } }										// EC_DRY_HEATING
+};
+static const app_error_policy_t app_error_policy_halt = { APP_EP_HALT, 0 };
+
 ErrorCode app_run()
 {
 	////////////////////////////////////// INITIALIZATION //////////////////////////////////////////
@@ -53,24 +73,48 @@ ErrorCode app_run()
 	app_state.stirrer_duty_cycle = 0;
 	app_state.fan_duty_cycle = app_state.settings.fan_duty_cycle;
 	app_state.heater_onoff = FALSE;
+	app_state.heater_duty_cycle = 0;
 	app_state.stirrer_onoff = FALSE;
 	app_state.fan_onoff = (app_state.fan_duty_cycle > 0 ? TRUE : FALSE);
 	app_state.heater_rapid_heating = FALSE;
+	app_state.eco_active = FALSE;
+	app_state.eco_last_input_time = 0;
+	app_state.degraded_error = EC_SUCCESS;
+	app_state.degraded_latched = FALSE;
+	app_state.error_probe = APP_NO_PROBE;
+	app_state.degraded_zones = 0;
+	for(uint8_t i = 0; i < TSENS_MAX_PROBES; ++i)
+		app_state.probe_errors[i] = EC_SUCCESS;
+	app_state.fault_history_next = 0;
+	app_state.fault_count = 0;
 	
 	
 	// initialize control
 	stirrer_fan_init();
 	stirrer_off();
+	agt_init(&app_state.agitation_state, app_state.settings.stirrer_waveform, app_state.settings.stirrer_period, app_state.settings.stirrer_depth);
 	fan_set_duty_cycle(app_state.fan_duty_cycle);
 	if(app_state.fan_onoff)
 		fan_on();
 	else
 		fan_off();	
+	fctl_init(&app_state.fan_control_state);
+	fcurve_init(&app_state.fan_curve_state, app_state.fan_duty_cycle);
 	heater_init();
 	heater_off();
+	app_apply_heater_output_settings();
 	
 	// initialize pid controller
-	pid_init(&app_state.pid_state, app_state.settings.heater_pid_kp, app_state.settings.heater_pid_ti, app_state.settings.heater_pid_td, app_state.settings.heater_pid_i_clamp, app_state.settings.heater_pid_offset, app_state.settings.heater_pid_d_smoothing_factor, HEATER_CONTROL_MIN, HEATER_CONTROL_MAX);
+	pid_init(&app_state.pid_state, app_state.settings.heater_pid_kp, app_state.settings.heater_pid_ti, app_state.settings.heater_pid_td, app_state.settings.heater_pid_i_clamp, app_state.settings.heater_pid_offset, app_state.settings.heater_pid_d_filter_cutoff, app_state.settings.heater_pid_d_filter_q, app_state.settings.heater_pid_sp_weight_p, app_state.settings.heater_pid_sp_weight_d, app_state.settings.heater_pid_sp_filter_tc, HEATER_CONTROL_MIN, HEATER_CONTROL_MAX);
+	#if HEATER_NUM_ZONES > 1
+		for(uint8_t i = 0; i < HEATER_NUM_ZONES - 1; ++i)
+		{
+			app_state.zones[i].onoff = FALSE;
+			app_state.zones[i].duty_cycle = 0;
+			app_state.zones[i].rapid_heating = FALSE;
+			pid_init(&app_state.zones[i].pid_state, app_state.settings.zones[i].gains.Kp, app_state.settings.zones[i].gains.Ti, app_state.settings.zones[i].gains.Td, app_state.settings.heater_pid_i_clamp, app_state.settings.heater_pid_offset, app_state.settings.heater_pid_d_filter_cutoff, app_state.settings.heater_pid_d_filter_q, 1.0, 0.0, 0.0, HEATER_CONTROL_MIN, HEATER_CONTROL_MAX);
+		}
+	#endif
 	
 	// initialize sensors
 	tsens_init();
@@ -86,9 +130,26 @@ ErrorCode app_run()
 	appt_set_callback(APP_ROT_ENC_UPDATE_INTERVAL, app_rotenc_update, 2);
 	appt_set_callback(APP_BUTTON_UPDATE_INTERVAL, app_button_update, 3);
 	
-	// initialize menu state
+	// recipe engine
+	appt_set_callback(APP_RECIPE_UPDATE_INTERVAL, app_recipe_update, 4);
+	
+	// stirrer waveform
+	appt_set_callback(APP_AGITATION_UPDATE_INTERVAL, app_agitation_update, 5);
+	
+	// fan curve and speed control
+	appt_set_callback(APP_FAN_UPDATE_INTERVAL, app_fan_update, 6);
+	
+	// relay / SSR heater output
+	appt_set_callback(APP_HEATER_OUTPUT_INTERVAL, app_heater_output_update, 7);
+	
+	// initialize menu state, the self-test hands over to the main screen
 	app_clear_input();
-	app_state.current_state_func = app_state_main;
+	#ifdef APP_SELF_TEST
+		app_state.self_test_step = APP_SELF_TEST_STEP_START;
+		app_state.current_state_func = app_state_self_test;
+	#else
+		app_state.current_state_func = app_state_main;
+	#endif
 	
 	// start adc
 	tsens_start_adc();
@@ -99,25 +160,45 @@ ErrorCode app_run()
 		if(app_state.current_error) { heater_shutdown(); stirrer_fan_shutdown(); tsens_shutdown(); rotenc_shutdown();	switch_shutdown(); app_error_display();	return app_state.current_error; }
 		app_state.t0_resistance = tsens_measure0_resistance(&app_state.current_error);
 		if(app_state.current_error) { heater_shutdown(); stirrer_fan_shutdown(); tsens_shutdown(); rotenc_shutdown();	switch_shutdown(); app_error_display();	return app_state.current_error; }
+		tsens_plausibility_reset(&app_state.t0_plausibility, app_state.t0_current_temp);
 	#endif
 	#ifdef TSENS_PROBE_1
 		app_state.t1_current_temp = tsens_measure_probe1_temp(&app_state.current_error);
 		if(app_state.current_error) { heater_shutdown(); stirrer_fan_shutdown(); tsens_shutdown(); rotenc_shutdown();	switch_shutdown(); app_error_display();	return app_state.current_error; }
 		app_state.t1_resistance = tsens_measure1_resistance(&app_state.current_error);
 		if(app_state.current_error) { heater_shutdown(); stirrer_fan_shutdown(); tsens_shutdown(); rotenc_shutdown();	switch_shutdown(); app_error_display();	return app_state.current_error; }
+		tsens_plausibility_reset(&app_state.t1_plausibility, app_state.t1_current_temp);
 	#endif
 	#ifdef TSENS_PROBE_2
 		app_state.t2_current_temp = tsens_measure_probe2_temp(&app_state.current_error);
 		if(app_state.current_error) { heater_shutdown(); stirrer_fan_shutdown(); tsens_shutdown(); rotenc_shutdown();	switch_shutdown(); app_error_display();	return app_state.current_error; }
 		app_state.t2_resistance = tsens_measure2_resistance(&app_state.current_error);
 		if(app_state.current_error) { heater_shutdown(); stirrer_fan_shutdown(); tsens_shutdown(); rotenc_shutdown();	switch_shutdown(); app_error_display();	return app_state.current_error; }
+		tsens_plausibility_reset(&app_state.t2_plausibility, app_state.t2_current_temp);
 	#endif
 	#ifdef TSENS_PROBE_3
 		app_state.t3_current_temp = tsens_measure_probe3_temp(&app_state.current_error);
 		if(app_state.current_error) { heater_shutdown(); stirrer_fan_shutdown(); tsens_shutdown(); rotenc_shutdown();	switch_shutdown(); app_error_display();	return app_state.current_error; }
 		app_state.t3_resistance = tsens_measure3_resistance(&app_state.current_error);
 		if(app_state.current_error) { heater_shutdown(); stirrer_fan_shutdown(); tsens_shutdown(); rotenc_shutdown();	switch_shutdown(); app_error_display();	return app_state.current_error; }
+		tsens_plausibility_reset(&app_state.t3_plausibility, app_state.t3_current_temp);
+	#endif
+	
+	#ifdef HEATER_VSENSE
+		app_state.supply_voltage = tsens_measure_supply_voltage();
+		heater_set_supply_voltage(app_state.supply_voltage);
 	#endif
+	
+	// initialize heat loss feedforward. The heater was off until now, so the safety probe reads roughly ambient temperature.
+	app_load_learned_from_eeprom();
+	app_load_recipe_from_eeprom();
+	app_load_stats_from_eeprom();
+	ff_init(&app_state.ff_state, app_state.heater_ff_gains[app_state.settings.controlling_tprobe], fmin(HEATER_SAFETY_TPROBE_CURRENT_TEMP, HEATER_FF_DEFAULT_AMBIENT_TEMP));
+	// initialize smith predictor, model gain depends on the learned feedforward gain
+	smith_init(&app_state.smith_state, HEATER_MODEL_DEFAULT_GAIN, app_state.settings.heater_model_tau, app_state.settings.heater_model_dead_time);
+	dob_init(&app_state.dob_state, HEATER_MODEL_DEFAULT_GAIN, app_state.settings.heater_model_tau);
+	trs_init(&app_state.trs_state, HEATER_MODEL_DEFAULT_GAIN, app_state.settings.heater_model_tau);
+	app_apply_pid_settings();
 		
 	// start app timer
 	appt_start();
@@ -127,9 +208,10 @@ ErrorCode app_run()
 	app_state.should_stop = FALSE;
 	while(!app_state.should_stop)
 	{
-		app_state.current_error = appt_update();
-		if(app_state.current_error)
-			app_state.should_stop = TRUE;
+		// faults hold the heater off, only a halting fault stops the main loop
+		ErrorCode ec = appt_update();
+		if(ec)
+			app_handle_error(ec);
 	}
 	if(app_state.current_error) // emergency shutdown. keep display alive for error display
 	{
@@ -174,6 +256,23 @@ ErrorCode app_user_main()
 	// Secondary Button
 	//---
 	
+	// eco standby: idle timer, the first input only wakes the controller up
+	appt_cycle_t now = appt_get_cycles_since_startup();
+	if(app_state.current_input.rotenc_delta != 0 || app_state.current_input.button_presses || app_state.current_input.button_long_presses || app_state.current_input.button_releases)
+	{
+		app_state.eco_last_input_time = now;
+		if(app_state.eco_active)
+		{
+			app_set_eco_standby(FALSE);
+			app_clear_input();
+		}
+	}
+	else if(app_state.settings.eco_onoff && !app_state.eco_active && !app_state.recipe_state.running
+		&& appt_cycles_to_seconds(now - app_state.eco_last_input_time) > app_state.settings.eco_timeout * 60.0)
+	{
+		app_set_eco_standby(TRUE);
+	}
+	
 	// query menu state machine
 	return (*app_state.current_state_func)();
 }
@@ -181,202 +280,129 @@ ErrorCode app_user_main()
 ///////////////////////////////////////// PID CONTROL CALLBACK ////////////////////////////////////
 ErrorCode app_control()
 {
+	ErrorCode probe_ec;
 	// do measurements
 	// if calibration menu is active, update corresponding resistance value
 	#ifdef TSENS_PROBE_0
-		// measure temperature and resistance, with open and short circuit protection
-		app_state.t0_current_temp = tsens_measure_probe0_temp(&app_state.current_error);
-		if(app_state.current_error)
-		{
-			return app_state.current_error;
-		}
-		if(app_state.current_state_func == app_state_menu_tprobe0_calib)
-		{
-			app_state.t0_resistance = tsens_measure0_resistance(&app_state.current_error);
-			if(app_state.current_error)
-			{
-				return app_state.current_error;
-			}
-		}
-		// min, max temp protection
-		if(app_state.t0_current_temp < HEATER_TR_PROTECTION_MIN_TEMP)
-			return EC_THERMISTOR_MIN_TEMP;
-		else if(app_state.t0_current_temp > HEATER_TR_PROTECTION_MAX_TEMP)
-			return EC_THERMISTOR_MAX_TEMP;
-		
-		// unresponsive thermistor protection
-		if(app_state.settings.controlling_tprobe == 0 || HEATER_SAFETY_TPROBE == 0)
-		{
-			if(app_state.heater_rapid_heating
-				&& (app_state.t0_current_temp - app_state.t0_tr_check_start_temp) < HEATER_PROBE0_TR_PROTECTION_EXPECTED_TEMP_CHANGE
-				&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t0_tr_check_start_time) > HEATER_PROBE0_TR_PROTECTION_INTERVAL) // if temp change under full power not reached within interval
-			{
-				return EC_THERMISTOR_NOT_RESPONDING;
-			}
-			else if(app_state.heater_rapid_heating
-				&& (app_state.t0_current_temp - app_state.t0_tr_check_start_temp) >= HEATER_PROBE0_TR_PROTECTION_EXPECTED_TEMP_CHANGE
-				&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t0_tr_check_start_time) <= HEATER_PROBE0_TR_PROTECTION_INTERVAL)// reset start temp and time for next cycle
-			{
-				app_state.t0_tr_check_start_temp = app_state.t0_current_temp;
-				app_state.t0_tr_check_start_time = appt_get_cycles_since_startup();
-			}
-		}
+		app_state.error_probe = 0;
+		probe_ec = app_update_probe0();
+		if(app_check_probe_fault(probe_ec))
+			return probe_ec;
 	#endif
 	
 	#ifdef TSENS_PROBE_1
-		app_state.t1_current_temp = tsens_measure_probe1_temp(&app_state.current_error);
-		if(app_state.current_error)
-		{
-			return app_state.current_error;
-		}
-		if(app_state.current_state_func == app_state_menu_tprobe1_calib)
-		{
-			app_state.t1_resistance = tsens_measure1_resistance(&app_state.current_error);
-			if(app_state.current_error)
-			{
-				return app_state.current_error;
-			}
-		}
-		// min, max temp protection
-		if(app_state.t1_current_temp < HEATER_TR_PROTECTION_MIN_TEMP)
-			return EC_THERMISTOR_MIN_TEMP;
-		else if(app_state.t1_current_temp > HEATER_TR_PROTECTION_MAX_TEMP)
-			return EC_THERMISTOR_MAX_TEMP;
-		
-		// unresponsive thermistor protection
-		if(app_state.settings.controlling_tprobe == 1 || HEATER_SAFETY_TPROBE == 1)
-		{
-			if(app_state.heater_rapid_heating
-				&& (app_state.t1_current_temp - app_state.t1_tr_check_start_temp) < HEATER_PROBE1_TR_PROTECTION_EXPECTED_TEMP_CHANGE
-				&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t1_tr_check_start_time) > HEATER_PROBE1_TR_PROTECTION_INTERVAL) // if temp change under full power not reached within interval
-			{
-				return EC_THERMISTOR_NOT_RESPONDING;
-			}
-			else if(app_state.heater_rapid_heating
-				&& (app_state.t1_current_temp - app_state.t1_tr_check_start_temp) >= HEATER_PROBE1_TR_PROTECTION_EXPECTED_TEMP_CHANGE
-				&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t1_tr_check_start_time) <= HEATER_PROBE1_TR_PROTECTION_INTERVAL)// reset start temp and time for next cycle
-			{
-				app_state.t1_tr_check_start_temp = app_state.t1_current_temp;
-				app_state.t1_tr_check_start_time = appt_get_cycles_since_startup();
-			}
-		}
+		app_state.error_probe = 1;
+		probe_ec = app_update_probe1();
+		if(app_check_probe_fault(probe_ec))
+			return probe_ec;
 	#endif
 	
 	#ifdef TSENS_PROBE_2
-		app_state.t2_current_temp = tsens_measure_probe2_temp(&app_state.current_error);
-		if(app_state.current_error)
-		{
-			return app_state.current_error;
-		}
-		if(app_state.current_state_func == app_state_menu_tprobe2_calib)
-		{
-			app_state.t2_resistance = tsens_measure2_resistance(&app_state.current_error);
-			if(app_state.current_error)
-			{
-				return app_state.current_error;
-			}
-		}
-		// min, max temp protection
-		if(app_state.t2_current_temp < HEATER_TR_PROTECTION_MIN_TEMP)
-			return EC_THERMISTOR_MIN_TEMP;
-		else if(app_state.t2_current_temp > HEATER_TR_PROTECTION_MAX_TEMP)
-			return EC_THERMISTOR_MAX_TEMP;
-		
-		// unresponsive thermistor protection
-		if(app_state.settings.controlling_tprobe == 2 || HEATER_SAFETY_TPROBE == 2)
-		{
-			if(app_state.heater_rapid_heating
-				&& (app_state.t2_current_temp - app_state.t2_tr_check_start_temp) < HEATER_PROBE2_TR_PROTECTION_EXPECTED_TEMP_CHANGE
-				&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t2_tr_check_start_time) > HEATER_PROBE2_TR_PROTECTION_INTERVAL) // if temp change under full power not reached within interval
-			{
-				return EC_THERMISTOR_NOT_RESPONDING;
-			}
-			else if(app_state.heater_rapid_heating
-				&& (app_state.t2_current_temp - app_state.t2_tr_check_start_temp) >= HEATER_PROBE2_TR_PROTECTION_EXPECTED_TEMP_CHANGE
-				&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t2_tr_check_start_time) <= HEATER_PROBE2_TR_PROTECTION_INTERVAL)// reset start temp and time for next cycle
-			{
-				app_state.t2_tr_check_start_temp = app_state.t2_current_temp;
-				app_state.t2_tr_check_start_time = appt_get_cycles_since_startup();
-			}
-		}
+		app_state.error_probe = 2;
+		probe_ec = app_update_probe2();
+		if(app_check_probe_fault(probe_ec))
+			return probe_ec;
 	#endif
 	
 	#ifdef TSENS_PROBE_3
-		app_state.t3_current_temp = tsens_measure_probe3_temp(&app_state.current_error);
-		if(app_state.current_error)
+		app_state.error_probe = 3;
+		probe_ec = app_update_probe3();
+		if(app_check_probe_fault(probe_ec))
+			return probe_ec;
+	#endif
+	app_state.error_probe = APP_NO_PROBE;
+	
+	// heater supply voltage, the output stage compensates the power for it
+	#ifdef HEATER_VSENSE
+		app_state.supply_voltage += HEATER_VSENSE_FILTER_ALPHA * (tsens_measure_supply_voltage() - app_state.supply_voltage);
+		heater_set_supply_voltage(app_state.supply_voltage);
+	#endif
+	
+	// pid stuff
+	float process_val;
+	uint8_t process_val_valid = app_get_probe_temp(app_state.settings.controlling_tprobe, &process_val);
+	if(process_val_valid)
+		app_state.process_value = process_val;
+	
+	// smith predictor: control on the predicted process value without dead time
+	float controlled_val = process_val;
+	if(app_state.settings.heater_smith_onoff)
+		controlled_val = smith_correct(&app_state.smith_state, process_val);
+	
+	// feedforward: learned heat loss plus compensation of disturbances detected by the observer
+	float disturbance_compensation = 0.0;
+	if(app_state.settings.heater_dob_onoff)
+		disturbance_compensation = dob_compensation(&app_state.dob_state, app_state.settings.heater_dob_threshold);
+	float feedforward = ff_output(&app_state.ff_state, app_state.settings.heater_target_temp) + disturbance_compensation;
+	pid_set_feedforward(&app_state.pid_state, feedforward);
+	
+	// the heater is held off in degraded mode
+	if(app_state.heater_onoff && !app_state.degraded_error)
+	{
+		if(!process_val_valid)
+			return EC_NO_CONTROLLING_TPROBE;
+		
+		// controlling probe changed while heating: continue from the current output on the new process value
+		if(app_state.settings.controlling_tprobe != app_state.heater_pid_tprobe)
 		{
-			return app_state.current_error;
+			pid_track(&app_state.pid_state, controlled_val, app_state.pid_state.output);
+			trs_reset(&app_state.trs_state);
+			dry_reset(&app_state.dry_state, HEATER_SAFETY_TPROBE_CURRENT_TEMP - process_val);
+			app_state.heater_pid_tprobe = app_state.settings.controlling_tprobe;
 		}
-		if(app_state.current_state_func == app_state_menu_tprobe3_calib)
+		// smith predictor switched while heating: the controlled value jumps between measurement and prediction, continue bumpless
+		if(app_state.settings.heater_smith_onoff != app_state.heater_pid_smith)
 		{
-			app_state.t3_resistance = tsens_measure3_resistance(&app_state.current_error);
-			if(app_state.current_error)
-			{
-				return app_state.current_error;
-			}
+			pid_track(&app_state.pid_state, controlled_val, app_state.pid_state.output);
+			app_state.heater_pid_smith = app_state.settings.heater_smith_onoff;
 		}
-		// min, max temp protection
-		if(app_state.t3_current_temp < HEATER_TR_PROTECTION_MIN_TEMP)
-			return EC_THERMISTOR_MIN_TEMP;
-		else if(app_state.t3_current_temp > HEATER_TR_PROTECTION_MAX_TEMP)
-			return EC_THERMISTOR_MAX_TEMP;
 		
-		// unresponsive thermistor protection
-		if(app_state.settings.controlling_tprobe == 3 || HEATER_SAFETY_TPROBE == 3)
+		float pid_res;
+		// explicit mpc needs a bath probe besides the heater mat probe and a set point covered by the tables, the pid takes over otherwise
+		if(app_state.settings.heater_mpc_onoff && app_state.settings.controlling_tprobe != HEATER_SAFETY_TPROBE && mpc_in_range(app_state.settings.heater_target_temp))
 		{
-			if(app_state.heater_rapid_heating
-				&& (app_state.t3_current_temp - app_state.t3_tr_check_start_temp) < HEATER_PROBE3_TR_PROTECTION_EXPECTED_TEMP_CHANGE
-				&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t3_tr_check_start_time) > HEATER_PROBE3_TR_PROTECTION_INTERVAL) // if temp change under full power not reached within interval
-			{
-				return EC_THERMISTOR_NOT_RESPONDING;
-			}
-			else if(app_state.heater_rapid_heating
-				&& (app_state.t3_current_temp - app_state.t3_tr_check_start_temp) >= HEATER_PROBE3_TR_PROTECTION_EXPECTED_TEMP_CHANGE
-				&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t3_tr_check_start_time) <= HEATER_PROBE3_TR_PROTECTION_INTERVAL)// reset start temp and time for next cycle
-			{
-				app_state.t3_tr_check_start_temp = app_state.t3_current_temp;
-				app_state.t3_tr_check_start_time = appt_get_cycles_since_startup();
-			}
+			// holding duty cycle of the plant model plus the optimal deviation for the dead time free bath error and the mat deviation
+			float bath_val = smith_correct(&app_state.smith_state, process_val);
+			float holding_duty = fmax(app_state.settings.heater_target_temp - app_state.ff_state.ambient_temp, 0.0) / app_get_model_gain() + disturbance_compensation;
+			float mat_deviation = HEATER_SAFETY_TPROBE_CURRENT_TEMP - (app_state.settings.heater_target_temp + HEATER_MAT_GRADIENT_PER_DUTY * holding_duty);
+			pid_res = fmax(fmin(holding_duty + mpc_output(app_state.settings.heater_target_temp, bath_val - app_state.settings.heater_target_temp, mat_deviation), HEATER_CONTROL_MAX), HEATER_CONTROL_MIN);
+			// pid follows, so switching back is bumpless
+			pid_track(&app_state.pid_state, controlled_val, pid_res);
 		}
-	#endif
-	
-	// pid stuff
-	if(app_state.heater_onoff)
-	{
-		float process_val;
-		switch(app_state.settings.controlling_tprobe)
+		else
 		{
-			#ifdef TSENS_PROBE_0
-			case 0:				
-				process_val = app_state.t0_current_temp;				
-				break;
-				#endif
-			#ifdef TSENS_PROBE_1
-			case 1:				
-				process_val = app_state.t1_current_temp;				
-				break;
-				#endif
-			#ifdef TSENS_PROBE_2
-			case 2:				
-				process_val = app_state.t2_current_temp;				
-				break;
-				#endif
-			#ifdef TSENS_PROBE_3
-			case 3:				
-				process_val = app_state.t3_current_temp;				
-				break;
-				#endif
-			default:
-				return EC_NO_CONTROLLING_TPROBE;
+			pid_res = pid_step(&app_state.pid_state, controlled_val, app_state.settings.heater_target_temp);
 		}
-		
-		float pid_res = pid_step(&app_state.pid_state, process_val, app_state.settings.heater_target_temp);
 		// if heater temp is > than safe maximum, default pwm duty cycle to 0
-		uint8_t hdc;
 		if(HEATER_SAFETY_TPROBE_CURRENT_TEMP > HEATER_MAX_OPERATING_TEMP) // HEATER_SAFETY_TPROBE_CURRENT_TEMP is the selected heater probe used to limit the maximum heater temperature
-			hdc = 0;
-		else
-			hdc = (uint8_t)pid_res;
+			pid_res = 0.0;
+		uint8_t hdc = (uint8_t)pid_res;
+		smith_step(&app_state.smith_state, pid_res);
+		dob_step(&app_state.dob_state, process_val, app_state.ff_state.ambient_temp, smith_get_delayed_duty(&app_state.smith_state));
+		
+		// detached probe or failed heater at any duty cycle
+		ErrorCode trs_ec = trs_step(&app_state.trs_state, process_val, app_state.ff_state.ambient_temp, smith_get_delayed_duty(&app_state.smith_state), app_state.dob_state.estimate);
+		if(trs_ec)
+			return trs_ec;
+		
+		// dry heating: mat decoupled from the bath
+		if(app_state.settings.controlling_tprobe != HEATER_SAFETY_TPROBE)
+		{
+			ErrorCode dry_ec = dry_step(&app_state.dry_state, HEATER_SAFETY_TPROBE_CURRENT_TEMP, process_val, pid_res, PID_DELTA_T);
+			if(dry_ec)
+				return dry_ec;
+		}
+		
+		// learn the holding duty cycle from settled periods
+		if(ff_learn(&app_state.ff_state, process_val, app_state.settings.heater_target_temp, pid_res))
+		{
+			app_state.heater_ff_gains[app_state.settings.controlling_tprobe] = app_state.ff_state.gain;
+			app_state.heater_ff_gains_dirty = TRUE;
+			// plant model gain follows the learned gain
+			app_apply_pid_settings();
+		}
+		// ambient temp only follows the probes after a whole window with the heater off
+		ff_reset_ambient_window(&app_state.ff_state, HEATER_SAFETY_TPROBE_CURRENT_TEMP);
 		
 		if(hdc >= HEATER_TR_DUTY_CYCLE && !app_state.heater_rapid_heating) // beginning of rapid heating period.
 		{
@@ -406,96 +432,615 @@ ErrorCode app_control()
 			app_state.heater_rapid_heating = FALSE;
 		}
 		
-		// set heater duty cycle
-		heater_set_duty_cycle(hdc);
+		// set heater duty cycle, full resolution of the controller output
+		heater_set_duty_cycle16((uint16_t)(fmax(fmin(pid_res, HEATER_CONTROL_MAX), HEATER_CONTROL_MIN) * (HEATER_DUTY_CYCLE16_MAX / 100.0) + 0.5));
+		app_state.heater_duty_cycle = hdc;
+		egy_step(&app_state.energy_state, pid_res, PID_DELTA_T);
+		eta_update(&app_state.eta_state, process_val, PID_DELTA_T);
+	}
+	else
+	{
+		app_state.heater_duty_cycle = 0;
+		// heater is off, probes cool down towards ambient temperature
+		ff_track_ambient(&app_state.ff_state, HEATER_SAFETY_TPROBE_CURRENT_TEMP);
+		smith_step(&app_state.smith_state, 0.0);
+		dob_reset(&app_state.dob_state);
+		trs_reset(&app_state.trs_state);
+		dry_reset(&app_state.dry_state, HEATER_SAFETY_TPROBE_CURRENT_TEMP - process_val);
+		// tracking mode: the pid follows the process value with the feedforward as output, so switching the heater on is bumpless
+		if(process_val_valid)
+			pid_track(&app_state.pid_state, controlled_val, app_state.pid_state.offset + feedforward);
+		app_state.heater_pid_tprobe = app_state.settings.controlling_tprobe;
+		app_state.heater_pid_smith = app_state.settings.heater_smith_onoff;
+	}
+	
+	// write learned values at a low rate to save eeprom write cycles
+	if(app_state.heater_ff_gains_dirty && appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.heater_ff_store_time) > HEATER_FF_STORE_INTERVAL)
+		app_store_learned_to_eeprom();
+	if(app_state.energy_state.lifetime_dirty && appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.energy_store_time) > HEATER_STATS_STORE_INTERVAL)
+		app_store_stats_to_eeprom();
+	
+	// additional heater zones are stepped in the same tick on the fresh measurements
+	#if HEATER_NUM_ZONES > 1
+		for(uint8_t i = 0; i < HEATER_NUM_ZONES - 1; ++i)
+		{
+			ErrorCode ec = app_zone_control(i);
+			if(ec)
+				return ec;
+		}
+	#endif
+	
+	// degraded mode: recoverable faults clear after enough fault free control steps
+	if(app_state.degraded_error && !app_state.degraded_latched
+		&& ++app_state.degraded_good_ticks >= app_get_error_policy(app_state.degraded_error, app_state.degraded_probe)->recover_ticks)
+	{
+		app_clear_degraded();
 	}
 	return EC_SUCCESS; // everything ok
 }
 
-/////////////////////////////////////// ROT_ENC UPDATE CALLBACK ///////////////////////////////////
-ErrorCode app_rotenc_update()
+// measurement and protection checks of the probes
+#ifdef TSENS_PROBE_0
+ErrorCode app_update_probe0()
 {
-	rotenc_update();
+	// measure temperature and resistance, with open and short circuit protection
+	float t0_temp = tsens_measure_probe0_temp(&app_state.current_error);
+	if(app_state.current_error)
+	{
+		return app_state.current_error;
+	}
+	// implausible jumps are rejected, the last value is held
+	app_state.t0_current_temp = tsens_check_plausibility(&app_state.t0_plausibility, t0_temp, TSENS_PROBE_0_MAX_RATE, PID_DELTA_T, &app_state.current_error);
+	if(app_state.current_error)
+	{
+		return app_state.current_error;
+	}
+	if(app_state.current_state_func == app_state_menu_tprobe0_calib)
+	{
+		app_state.t0_resistance = tsens_measure0_resistance(&app_state.current_error);
+		if(app_state.current_error)
+		{
+			return app_state.current_error;
+		}
+	}
+	// min, max temp protection
+	if(app_state.t0_current_temp < HEATER_TR_PROTECTION_MIN_TEMP)
+		return EC_THERMISTOR_MIN_TEMP;
+	else if(app_state.t0_current_temp > HEATER_TR_PROTECTION_MAX_TEMP)
+		return EC_THERMISTOR_MAX_TEMP;
+	
+	// unresponsive thermistor protection
+	if(app_state.settings.controlling_tprobe == 0 || HEATER_SAFETY_TPROBE == 0)
+	{
+		if(app_state.heater_rapid_heating
+			&& (app_state.t0_current_temp - app_state.t0_tr_check_start_temp) < HEATER_PROBE0_TR_PROTECTION_EXPECTED_TEMP_CHANGE
+			&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t0_tr_check_start_time) > HEATER_PROBE0_TR_PROTECTION_INTERVAL) // if temp change under full power not reached within interval
+		{
+			return EC_THERMISTOR_NOT_RESPONDING;
+		}
+		else if(app_state.heater_rapid_heating
+			&& (app_state.t0_current_temp - app_state.t0_tr_check_start_temp) >= HEATER_PROBE0_TR_PROTECTION_EXPECTED_TEMP_CHANGE
+			&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t0_tr_check_start_time) <= HEATER_PROBE0_TR_PROTECTION_INTERVAL)// reset start temp and time for next cycle
+		{
+			app_state.t0_tr_check_start_temp = app_state.t0_current_temp;
+			app_state.t0_tr_check_start_time = appt_get_cycles_since_startup();
+		}
+	}
 	return EC_SUCCESS;
 }
+#endif
 
-/////////////////////////////////////// BUTTONS UPDATE CALLBACK ///////////////////////////////////
-ErrorCode app_button_update()
+#ifdef TSENS_PROBE_1
+ErrorCode app_update_probe1()
 {
-	switch_update();
+	float t1_temp = tsens_measure_probe1_temp(&app_state.current_error);
+	if(app_state.current_error)
+	{
+		return app_state.current_error;
+	}
+	// implausible jumps are rejected, the last value is held
+	app_state.t1_current_temp = tsens_check_plausibility(&app_state.t1_plausibility, t1_temp, TSENS_PROBE_1_MAX_RATE, PID_DELTA_T, &app_state.current_error);
+	if(app_state.current_error)
+	{
+		return app_state.current_error;
+	}
+	if(app_state.current_state_func == app_state_menu_tprobe1_calib)
+	{
+		app_state.t1_resistance = tsens_measure1_resistance(&app_state.current_error);
+		if(app_state.current_error)
+		{
+			return app_state.current_error;
+		}
+	}
+	// min, max temp protection
+	if(app_state.t1_current_temp < HEATER_TR_PROTECTION_MIN_TEMP)
+		return EC_THERMISTOR_MIN_TEMP;
+	else if(app_state.t1_current_temp > HEATER_TR_PROTECTION_MAX_TEMP)
+		return EC_THERMISTOR_MAX_TEMP;
+	
+	// unresponsive thermistor protection
+	if(app_state.settings.controlling_tprobe == 1 || HEATER_SAFETY_TPROBE == 1)
+	{
+		if(app_state.heater_rapid_heating
+			&& (app_state.t1_current_temp - app_state.t1_tr_check_start_temp) < HEATER_PROBE1_TR_PROTECTION_EXPECTED_TEMP_CHANGE
+			&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t1_tr_check_start_time) > HEATER_PROBE1_TR_PROTECTION_INTERVAL) // if temp change under full power not reached within interval
+		{
+			return EC_THERMISTOR_NOT_RESPONDING;
+		}
+		else if(app_state.heater_rapid_heating
+			&& (app_state.t1_current_temp - app_state.t1_tr_check_start_temp) >= HEATER_PROBE1_TR_PROTECTION_EXPECTED_TEMP_CHANGE
+			&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t1_tr_check_start_time) <= HEATER_PROBE1_TR_PROTECTION_INTERVAL)// reset start temp and time for next cycle
+		{
+			app_state.t1_tr_check_start_temp = app_state.t1_current_temp;
+			app_state.t1_tr_check_start_time = appt_get_cycles_since_startup();
+		}
+	}
 	return EC_SUCCESS;
 }
+#endif
 
-/////////////////////////////////////// STATE MACHINE IMPLEMENTATION //////////////////////////////
-// all the state functions
-ErrorCode app_state_main()
+#ifdef TSENS_PROBE_2
+ErrorCode app_update_probe2()
 {
-	if(app_state.current_input.rotenc_delta > 0)
-		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 1), 0);
-	else if(app_state.current_input.rotenc_delta < 0)
-		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 1), 0);
-	// display current temp
-	srd_clear();
-	switch(app_state.selected_menu_item_index)
+	float t2_temp = tsens_measure_probe2_temp(&app_state.current_error);
+	if(app_state.current_error)
 	{
-		#ifdef TSENS_PROBE_0
-		case 0:
-			mr_main(app_state.t0_current_temp, 0);
-			break;
-			#endif
-		#ifdef TSENS_PROBE_1
-		case 1:
-			mr_main(app_state.t1_current_temp, 1);
-			break;
-			#endif
-		#ifdef TSENS_PROBE_2
-		case 2:
-			mr_main(app_state.t2_current_temp, 2);
-			break;
-			#endif
-		#ifdef TSENS_PROBE_3
-		case 3:
-			mr_main(app_state.t3_current_temp, 3);
-			break;
-			#endif
-		default:
-			return EC_NO_CONTROLLING_TPROBE;
-			break;
+		return app_state.current_error;
 	}
-	srd_display();
-	
-	// state change
-	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	// implausible jumps are rejected, the last value is held
+	app_state.t2_current_temp = tsens_check_plausibility(&app_state.t2_plausibility, t2_temp, TSENS_PROBE_2_MAX_RATE, PID_DELTA_T, &app_state.current_error);
+	if(app_state.current_error)
 	{
-		app_state.selected_menu_item_index = 0;
-		app_state.current_state_func = app_state_menu_main;
+		return app_state.current_error;
+	}
+	if(app_state.current_state_func == app_state_menu_tprobe2_calib)
+	{
+		app_state.t2_resistance = tsens_measure2_resistance(&app_state.current_error);
+		if(app_state.current_error)
+		{
+			return app_state.current_error;
+		}
 	}
+	// min, max temp protection
+	if(app_state.t2_current_temp < HEATER_TR_PROTECTION_MIN_TEMP)
+		return EC_THERMISTOR_MIN_TEMP;
+	else if(app_state.t2_current_temp > HEATER_TR_PROTECTION_MAX_TEMP)
+		return EC_THERMISTOR_MAX_TEMP;
 	
-	return EC_SUCCESS; // everything ok	
+	// unresponsive thermistor protection
+	if(app_state.settings.controlling_tprobe == 2 || HEATER_SAFETY_TPROBE == 2)
+	{
+		if(app_state.heater_rapid_heating
+			&& (app_state.t2_current_temp - app_state.t2_tr_check_start_temp) < HEATER_PROBE2_TR_PROTECTION_EXPECTED_TEMP_CHANGE
+			&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t2_tr_check_start_time) > HEATER_PROBE2_TR_PROTECTION_INTERVAL) // if temp change under full power not reached within interval
+		{
+			return EC_THERMISTOR_NOT_RESPONDING;
+		}
+		else if(app_state.heater_rapid_heating
+			&& (app_state.t2_current_temp - app_state.t2_tr_check_start_temp) >= HEATER_PROBE2_TR_PROTECTION_EXPECTED_TEMP_CHANGE
+			&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t2_tr_check_start_time) <= HEATER_PROBE2_TR_PROTECTION_INTERVAL)// reset start temp and time for next cycle
+		{
+			app_state.t2_tr_check_start_temp = app_state.t2_current_temp;
+			app_state.t2_tr_check_start_time = appt_get_cycles_since_startup();
+		}
+	}
+	return EC_SUCCESS;
 }
+#endif
 
-ErrorCode app_state_menu_main()
+#ifdef TSENS_PROBE_3
+ErrorCode app_update_probe3()
 {
-	if(app_state.current_input.rotenc_delta > 0)
-		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 6), 0);
-	else if(app_state.current_input.rotenc_delta < 0)
-		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 6), 0);
-	// display selected menu item
-	srd_clear();
-	mr_main_menu(app_state.selected_menu_item_index);
-	srd_display();
+	float t3_temp = tsens_measure_probe3_temp(&app_state.current_error);
+	if(app_state.current_error)
+	{
+		return app_state.current_error;
+	}
+	// implausible jumps are rejected, the last value is held
+	app_state.t3_current_temp = tsens_check_plausibility(&app_state.t3_plausibility, t3_temp, TSENS_PROBE_3_MAX_RATE, PID_DELTA_T, &app_state.current_error);
+	if(app_state.current_error)
+	{
+		return app_state.current_error;
+	}
+	if(app_state.current_state_func == app_state_menu_tprobe3_calib)
+	{
+		app_state.t3_resistance = tsens_measure3_resistance(&app_state.current_error);
+		if(app_state.current_error)
+		{
+			return app_state.current_error;
+		}
+	}
+	// min, max temp protection
+	if(app_state.t3_current_temp < HEATER_TR_PROTECTION_MIN_TEMP)
+		return EC_THERMISTOR_MIN_TEMP;
+	else if(app_state.t3_current_temp > HEATER_TR_PROTECTION_MAX_TEMP)
+		return EC_THERMISTOR_MAX_TEMP;
 	
-	// state change
-	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	// unresponsive thermistor protection
+	if(app_state.settings.controlling_tprobe == 3 || HEATER_SAFETY_TPROBE == 3)
 	{
-		switch(app_state.selected_menu_item_index)
+		if(app_state.heater_rapid_heating
+			&& (app_state.t3_current_temp - app_state.t3_tr_check_start_temp) < HEATER_PROBE3_TR_PROTECTION_EXPECTED_TEMP_CHANGE
+			&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t3_tr_check_start_time) > HEATER_PROBE3_TR_PROTECTION_INTERVAL) // if temp change under full power not reached within interval
 		{
-			case 0:	// back to main screen
-				app_state.selected_menu_item_index = 0;
-				app_state.current_state_func = app_state_main;
-				break;
-			case 1: // heater menu
-				app_state.selected_menu_item_index = 0;
+			return EC_THERMISTOR_NOT_RESPONDING;
+		}
+		else if(app_state.heater_rapid_heating
+			&& (app_state.t3_current_temp - app_state.t3_tr_check_start_temp) >= HEATER_PROBE3_TR_PROTECTION_EXPECTED_TEMP_CHANGE
+			&& appt_cycles_to_seconds(appt_get_cycles_since_startup() - app_state.t3_tr_check_start_time) <= HEATER_PROBE3_TR_PROTECTION_INTERVAL)// reset start temp and time for next cycle
+		{
+			app_state.t3_tr_check_start_temp = app_state.t3_current_temp;
+			app_state.t3_tr_check_start_time = appt_get_cycles_since_startup();
+		}
+	}
+	return EC_SUCCESS;
+}
+#endif
+
+#if HEATER_NUM_ZONES > 1
+ErrorCode app_zone_control(uint8_t zone_index)
+{
+	app_zone_settings_t* settings = &app_state.settings.zones[zone_index];
+	app_zone_state_t* zone = &app_state.zones[zone_index];
+	float process_val;
+	uint8_t process_val_valid = app_get_probe_temp(settings->controlling_tprobe, &process_val);
+	
+	if(!zone->onoff)
+	{
+		zone->duty_cycle = 0;
+		zone->rapid_heating = FALSE;
+		// bumpless switch on
+		if(process_val_valid)
+			pid_track(&zone->pid_state, process_val, zone->pid_state.offset);
+		return EC_SUCCESS;
+	}
+	if(!process_val_valid)
+		return EC_NO_CONTROLLING_TPROBE;
+	
+	float pid_res = pid_step(&zone->pid_state, process_val, settings->target_temp);
+	// the zone probe sits on the zone heater, limit it like the main heater mat
+	if(process_val > HEATER_MAX_OPERATING_TEMP)
+		pid_res = 0.0;
+	uint8_t dc = (uint8_t)fmax(fmin(pid_res, HEATER_CONTROL_MAX), HEATER_CONTROL_MIN);
+	
+	// unresponsive thermistor protection, the zone probe has to follow a full power period
+	appt_cycle_t now = appt_get_cycles_since_startup();
+	if(dc >= HEATER_TR_DUTY_CYCLE)
+	{
+		if(!zone->rapid_heating) // beginning of rapid heating period
+		{
+			zone->rapid_heating = TRUE;
+			zone->tr_check_start_temp = process_val;
+			zone->tr_check_start_time = now;
+		}
+		else if(process_val - zone->tr_check_start_temp >= HEATER_ZONE_TR_PROTECTION_EXPECTED_TEMP_CHANGE) // reset start temp and time for next cycle
+		{
+			zone->tr_check_start_temp = process_val;
+			zone->tr_check_start_time = now;
+		}
+		else if(appt_cycles_to_seconds(now - zone->tr_check_start_time) > HEATER_ZONE_TR_PROTECTION_INTERVAL)
+		{
+			return EC_THERMISTOR_NOT_RESPONDING;
+		}
+	}
+	else
+	{
+		zone->rapid_heating = FALSE;
+	}
+	
+	heater_zone_set_duty_cycle(zone_index + 1, dc);
+	zone->duty_cycle = dc;
+	return EC_SUCCESS;
+}
+#endif
+
+/////////////////////////////////////// ROT_ENC UPDATE CALLBACK ///////////////////////////////////
+ErrorCode app_rotenc_update()
+{
+	rotenc_update();
+	return EC_SUCCESS;
+}
+
+/////////////////////////////////////// BUTTONS UPDATE CALLBACK ///////////////////////////////////
+ErrorCode app_button_update()
+{
+	switch_update();
+	return EC_SUCCESS;
+}
+
+/////////////////////////////////////// RECIPE UPDATE CALLBACK ////////////////////////////////////
+ErrorCode app_recipe_update()
+{
+	uint8_t actions = rcp_update(&app_state.recipe_state, app_state.recipe, app_state.process_value, APP_RECIPE_UPDATE_INTERVAL);
+	// set point changes are ramped, so the pid sees a continuous set point
+	if(actions & RCP_ACTION_SET_POINT)
+		app_set_target_temp(app_state.recipe_state.set_point);
+	if(actions & RCP_ACTION_STIRRER)
+		app_set_stirrer_duty_cycle(app_state.recipe_state.stirrer_duty_cycle);
+	if(actions & RCP_ACTION_IDLE)
+	{
+		app_set_heater_onoff(FALSE);
+		app_set_stirrer_duty_cycle(0);
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_agitation_update()
+{
+	uint8_t duty_cycle = agt_update(&app_state.agitation_state);
+	// the pwm output stays enabled while the waveform passes through zero, it is switched off after the stirrer spun down
+	uint8_t onoff = agt_active(&app_state.agitation_state);
+	if(!app_state.stirrer_onoff && onoff)
+		stirrer_on();
+	else if(app_state.stirrer_onoff && !onoff)
+		stirrer_off();
+	app_state.stirrer_onoff = onoff;
+	
+	stirrer_set_duty_cycle(duty_cycle);
+	return EC_SUCCESS;
+}
+
+ErrorCode app_fan_update()
+{
+	ErrorCode ec = EC_SUCCESS;
+	// the self-test drives the fan itself
+	if(app_state.current_state_func == app_state_self_test)
+		return ec;
+	// automatic fan speed from the heater duty cycle and the enclosure temperature
+	if(app_state.settings.fan_curve_onoff)
+	{
+		float load = app_state.heater_duty_cycle;
+		#ifdef FAN_CURVE_TPROBE
+			load = fmax(load, fcurve_temp_load(FAN_CURVE_TPROBE_CURRENT_TEMP));
+		#endif
+		app_set_fan_duty_cycle(fcurve_update(&app_state.fan_curve_state, load, app_state.settings.fan_idle_duty_cycle, app_state.settings.fan_duty_cycle));
+	}
+	
+	#ifdef FAN_TACH
+	uint16_t pulses;
+	uint32_t last_pulse_cycles;
+	fan_tach_read(&pulses, &last_pulse_cycles);
+	fctl_measure(&app_state.fan_control_state, pulses, last_pulse_cycles);
+	if(app_state.settings.fan_closed_loop_onoff)
+	{
+		// fan speed setting in % of the rated speed
+		uint8_t duty_cycle = app_state.fan_onoff ? fctl_step(&app_state.fan_control_state, app_state.fan_duty_cycle * (FAN_TACH_MAX_RPM / 100.0)) : 0;
+		fan_set_duty_cycle(duty_cycle);
+		// stall detection needs the tach wire, so it is only active in closed loop mode
+		fctl_check_stall(&app_state.fan_control_state, duty_cycle, &ec);
+	}
+	#endif
+	return ec;
+}
+
+ErrorCode app_heater_output_update()
+{
+	heater_output_update();
+	return EC_SUCCESS;
+}
+
+/////////////////////////////////////// STATE MACHINE IMPLEMENTATION //////////////////////////////
+// all the state functions
+ErrorCode app_state_self_test()
+{
+	appt_cycle_t now = appt_get_cycles_since_startup();
+	switch(app_state.self_test_step)
+	{
+		case APP_SELF_TEST_STEP_START:
+		{
+			// adc noise of every probe
+			ErrorCode ec = EC_SUCCESS;
+			#ifdef TSENS_PROBE_0
+				if(tsens_measure_raw_spread(tsens_measure0_raw, APP_SELF_TEST_ADC_SAMPLES, &ec) > APP_SELF_TEST_ADC_MAX_SPREAD || ec)
+				{
+					app_finish_self_test(APP_SELF_TEST_FAIL_ADC, 0);
+					break;
+				}
+			#endif
+			#ifdef TSENS_PROBE_1
+				if(tsens_measure_raw_spread(tsens_measure1_raw, APP_SELF_TEST_ADC_SAMPLES, &ec) > APP_SELF_TEST_ADC_MAX_SPREAD || ec)
+				{
+					app_finish_self_test(APP_SELF_TEST_FAIL_ADC, 1);
+					break;
+				}
+			#endif
+			#ifdef TSENS_PROBE_2
+				if(tsens_measure_raw_spread(tsens_measure2_raw, APP_SELF_TEST_ADC_SAMPLES, &ec) > APP_SELF_TEST_ADC_MAX_SPREAD || ec)
+				{
+					app_finish_self_test(APP_SELF_TEST_FAIL_ADC, 2);
+					break;
+				}
+			#endif
+			#ifdef TSENS_PROBE_3
+				if(tsens_measure_raw_spread(tsens_measure3_raw, APP_SELF_TEST_ADC_SAMPLES, &ec) > APP_SELF_TEST_ADC_MAX_SPREAD || ec)
+				{
+					app_finish_self_test(APP_SELF_TEST_FAIL_ADC, 3);
+					break;
+				}
+			#endif
+			
+			// heater pulse at full power, the control loop keeps its probe protections meanwhile
+			if(app_state.degraded_error)
+			{
+				app_finish_self_test(APP_SELF_TEST_FAIL_HEATER, APP_NO_PROBE);
+				break;
+			}
+			app_state.self_test_start_temp = HEATER_SAFETY_TPROBE_CURRENT_TEMP;
+			app_state.self_test_start_time = now;
+			app_state.self_test_passed = 0;
+			heater_set_duty_cycle16(HEATER_DUTY_CYCLE16_MAX);
+			heater_on();
+			// fan at full speed in parallel, it has to deliver tach pulses. Without tach wire there is no feedback to check.
+			#ifdef FAN_TACH
+				uint32_t last_pulse_cycles;
+				fan_tach_read(&app_state.self_test_start_pulses, &last_pulse_cycles);
+				fan_set_duty_cycle(100);
+				fan_on();
+			#else
+				app_state.self_test_passed |= APP_SELF_TEST_FAN_OK;
+			#endif
+			app_state.self_test_step = APP_SELF_TEST_STEP_PULSE;
+			break;
+		}
+		case APP_SELF_TEST_STEP_PULSE:
+		{
+			float elapsed = appt_cycles_to_seconds(now - app_state.self_test_start_time);
+			if(HEATER_SAFETY_TPROBE_CURRENT_TEMP - app_state.self_test_start_temp >= APP_SELF_TEST_MIN_RISE)
+				app_state.self_test_passed |= APP_SELF_TEST_HEATER_OK;
+			#ifdef FAN_TACH
+				uint16_t pulses;
+				uint32_t last_pulse_cycles;
+				fan_tach_read(&pulses, &last_pulse_cycles);
+				if((uint16_t)(pulses - app_state.self_test_start_pulses) >= APP_SELF_TEST_FAN_MIN_PULSES)
+					app_state.self_test_passed |= APP_SELF_TEST_FAN_OK;
+			#endif
+			
+			if(app_state.self_test_passed == (APP_SELF_TEST_HEATER_OK | APP_SELF_TEST_FAN_OK))
+			{
+				app_finish_self_test(APP_SELF_TEST_PASS, APP_NO_PROBE);
+			}
+			else if(elapsed > APP_SELF_TEST_RESPONSE_TIME || app_state.degraded_error)
+			{
+				app_finish_self_test((app_state.self_test_passed & APP_SELF_TEST_HEATER_OK) ? APP_SELF_TEST_FAIL_FAN : APP_SELF_TEST_FAIL_HEATER, APP_NO_PROBE);
+			}
+			else if(elapsed > APP_SELF_TEST_PULSE_TIME || (app_state.self_test_passed & APP_SELF_TEST_HEATER_OK))
+			{
+				// end of the pulse, the mat probe may still follow
+				heater_set_duty_cycle16(0);
+				heater_off();
+			}
+			break;
+		}
+		default:
+			break;
+	}
+	
+	// display progress / result
+	srd_clear();
+	if(app_state.self_test_step == APP_SELF_TEST_STEP_RESULT)
+		mr_self_test_result(app_state.self_test_result, app_state.self_test_probe);
+	else
+		mr_self_test(app_state.self_test_step);
+	srd_display();
+	
+	// state change: a pass is shown for a moment, a failure until it is acknowledged. A button press skips the test.
+	if(app_state.current_input.button_presses & (1 << BUTTON0)
+		|| (app_state.self_test_step == APP_SELF_TEST_STEP_RESULT && app_state.self_test_result == APP_SELF_TEST_PASS
+			&& appt_cycles_to_seconds(now - app_state.self_test_start_time) > APP_SELF_TEST_PASS_TIME))
+	{
+		// skipped test: end a running heater pulse
+		if(app_state.self_test_step != APP_SELF_TEST_STEP_RESULT)
+			app_stop_self_test_outputs();
+		app_state.selected_menu_item_index = 0;
+		app_state.current_state_func = app_state_main;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_main()
+{
+	// recipe progress page after the probe pages while a recipe is running
+	int8_t last_page = app_state.recipe_state.running ? 2 : 1;
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, last_page), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, last_page), 0);
+	else
+		app_state.selected_menu_item_index = imin8(app_state.selected_menu_item_index, last_page);
+	// display current temp
+	srd_clear();
+	if(app_state.selected_menu_item_index == 2)
+	{
+		mr_recipe_progress(app_state.recipe_state.segment, rcp_progress(&app_state.recipe_state, app_state.recipe));
+	}
+	else if(app_state.degraded_error && ((uint32_t)(appt_cycles_to_seconds(appt_get_cycles_since_startup()) / APP_MAIN_ALTERNATE_TIME) & 1))
+	{
+		mr_thermistor_error(app_state.degraded_error);
+	}
+	else if(app_state.probe_errors[app_state.selected_menu_item_index] && ((uint32_t)(appt_cycles_to_seconds(appt_get_cycles_since_startup()) / APP_MAIN_ALTERNATE_TIME) & 1))
+	{
+		// logged fault of the shown auxiliary probe, its last good temperature is shown in between
+		mr_thermistor_error(app_state.probe_errors[app_state.selected_menu_item_index]);
+	}
+	else if(app_state.eco_active && ((uint32_t)(appt_cycles_to_seconds(appt_get_cycles_since_startup()) / APP_MAIN_ALTERNATE_TIME) & 1))
+	{
+		mr_eco_standby();
+	}
+	else if(app_state.heater_onoff && ((uint32_t)(appt_cycles_to_seconds(appt_get_cycles_since_startup()) / APP_MAIN_ALTERNATE_TIME) & 1))
+	{
+		// time to set point while heating up, "READY" within the band
+		mr_time_to_ready(app_get_time_to_ready());
+	}
+	else
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			#ifdef TSENS_PROBE_0
+			case 0:
+				mr_main(app_state.t0_current_temp, 0);
+				break;
+				#endif
+			#ifdef TSENS_PROBE_1
+			case 1:
+				mr_main(app_state.t1_current_temp, 1);
+				break;
+				#endif
+			#ifdef TSENS_PROBE_2
+			case 2:
+				mr_main(app_state.t2_current_temp, 2);
+				break;
+				#endif
+			#ifdef TSENS_PROBE_3
+			case 3:
+				mr_main(app_state.t3_current_temp, 3);
+				break;
+				#endif
+			default:
+				return EC_NO_CONTROLLING_TPROBE;
+				break;
+		}
+	}
+	srd_display();
+	
+	// state change, the first press acknowledges a latched fault
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		if(app_state.degraded_latched)
+		{
+			app_acknowledge_fault();
+		}
+		else
+		{
+			app_state.selected_menu_item_index = 0;
+			app_state.current_state_func = app_state_menu_main;
+		}
+	}
+	
+	return EC_SUCCESS; // everything ok	
+}
+
+ErrorCode app_state_menu_main()
+{
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, APP_MAIN_MENU_LAST_ITEM), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, APP_MAIN_MENU_LAST_ITEM), 0);
+	// display selected menu item
+	srd_clear();
+	mr_main_menu(app_state.selected_menu_item_index);
+	srd_display();
+	
+	// state change
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to main screen
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_main;
+				break;
+			case 1: // heater menu
+				app_state.selected_menu_item_index = 0;
 				app_state.current_state_func = app_state_menu_heater;
 				break;
 			case 2:	// stirrer menu
@@ -520,6 +1065,20 @@ ErrorCode app_state_menu_main()
 				//app_state.current_state_func = app_state_menu_store_eeprom_settings;
 				app_store_settings_to_eeprom();
 				break;
+			case 7:	// recipe menu
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_recipe;
+				break;
+			case 8:	// heater statistics
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_stats;
+				break;
+			#if HEATER_NUM_ZONES > 1
+			case 9:	// heater zones menu
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_zone;
+				break;
+			#endif
 		}
 	}
 	return EC_SUCCESS;
@@ -528,9 +1087,9 @@ ErrorCode app_state_menu_main()
 ErrorCode app_state_menu_heater()
 {
 	if(app_state.current_input.rotenc_delta > 0)
-		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 4), 0);
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 6), 0);
 	else if(app_state.current_input.rotenc_delta < 0)
-		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 4), 0);
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 6), 0);
 	// display selected menu item
 	srd_clear();
 	mr_heater_menu(app_state.selected_menu_item_index);
@@ -561,6 +1120,14 @@ ErrorCode app_state_menu_heater()
 				app_state.selected_menu_item_index = 0;
 				app_state.current_state_func = app_state_menu_heater_pid;
 				break;
+			case 5:	// heater output menu
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_output;
+				break;
+			case 6:	// eco standby menu
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_eco;
+				break;
 		}
 	}
 	return EC_SUCCESS;
@@ -569,19 +1136,7 @@ ErrorCode app_state_menu_heater()
 ErrorCode app_state_menu_heater_onoff()
 {
 	if(app_state.current_input.rotenc_delta != 0)
-	{
-		app_state.heater_onoff = !app_state.heater_onoff;
-		if(app_state.heater_onoff)
-		{
-			heater_on();
-		}
-		else
-		{
-			heater_off();
-			app_state.heater_rapid_heating = FALSE;
-		}
-		pid_reset(&app_state.pid_state);
-	}
+		app_set_heater_onoff(!app_state.heater_onoff);
 	
 	// display current value
 	srd_clear();
@@ -599,7 +1154,7 @@ ErrorCode app_state_menu_heater_onoff()
 ErrorCode app_state_menu_heater_target_temp()
 {
 	if(app_state.current_input.rotenc_delta != 0)
-		app_state.settings.heater_target_temp = fmax(fmin(app_state.settings.heater_target_temp + app_state.current_input.rotenc_delta * TEMP_CHANGE_PER_ROTENC_STEP, MAX_HEATER_TARGET_TEMP), MIN_HEATER_TARGET_TEMP);
+		app_set_target_temp(app_state.settings.heater_target_temp + app_state.current_input.rotenc_delta * TEMP_CHANGE_PER_ROTENC_STEP);
 	
 	// display current value
 	srd_clear();
@@ -667,6 +1222,9 @@ ErrorCode app_state_menu_heater_controlling_tprobe()
 		if(selection_valid)
 		{
 			app_state.settings.controlling_tprobe = (uint8_t)app_state.selected_menu_item_index;
+			dob_reset(&app_state.dob_state);
+			ff_set_gain(&app_state.ff_state, app_state.heater_ff_gains[app_state.settings.controlling_tprobe]);
+			app_apply_pid_settings();
 			app_state.selected_menu_item_index = 3;
 			app_state.current_state_func = app_state_menu_heater;
 		}		
@@ -674,15 +1232,15 @@ ErrorCode app_state_menu_heater_controlling_tprobe()
 	return EC_SUCCESS;
 }
 
-ErrorCode app_state_menu_heater_pid()
+ErrorCode app_state_menu_heater_output()
 {
 	if(app_state.current_input.rotenc_delta > 0)
-		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 6), 0);
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 2), 0);
 	else if(app_state.current_input.rotenc_delta < 0)
-		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 6), 0);
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 2), 0);
 	// display selected menu item
 	srd_clear();
-	mr_heater_menu_pid(app_state.selected_menu_item_index);
+	mr_heater_menu_output(app_state.selected_menu_item_index);
 	srd_display();
 	
 	// state change
@@ -690,97 +1248,295 @@ ErrorCode app_state_menu_heater_pid()
 	{
 		switch(app_state.selected_menu_item_index)
 		{
-			case 0:	// back to main menu
-				app_state.selected_menu_item_index = 4;
+			case 0:	// back to heater menu
+				app_state.selected_menu_item_index = 5;
 				app_state.current_state_func = app_state_menu_heater;
 				break;
-			case 1: // P
-				app_state.selected_menu_item_index = 0;
-				app_state.current_state_func = app_state_menu_heater_pid_p;
-				break;
-			case 2:	// I
-				app_state.selected_menu_item_index = 0;
-				app_state.current_state_func = app_state_menu_heater_pid_i;
-				break;
-			case 3:	// D
-				app_state.selected_menu_item_index = 0;
-				app_state.current_state_func = app_state_menu_heater_pid_d;
-				break;
-			case 4:	// I-CLAMP
-				app_state.selected_menu_item_index = 0;
-				app_state.current_state_func = app_state_menu_heater_pid_i_clamp;
-				break;
-			case 5:	// OFFSET
+			case 1: // output backend
 				app_state.selected_menu_item_index = 0;
-				app_state.current_state_func = app_state_menu_heater_pid_offset;
+				app_state.current_state_func = app_state_menu_heater_output_mode;
 				break;
-			case 6:	// DSMOOTH
+			case 2:	// time proportioning window
 				app_state.selected_menu_item_index = 0;
-				app_state.current_state_func = app_state_menu_heater_pid_d_smoothing_factor;
+				app_state.current_state_func = app_state_menu_heater_output_window;
 				break;
 		}
 	}
 	return EC_SUCCESS;
 }
 
-ErrorCode app_state_menu_heater_pid_p()
+ErrorCode app_state_menu_heater_output_mode()
 {
 	if(app_state.current_input.rotenc_delta != 0)
 	{
-		app_state.settings.heater_pid_kp = fmax(fmin(app_state.settings.heater_pid_kp + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_P), MIN_HEATER_PID_P);
-		pid_set_params(&app_state.pid_state, app_state.settings.heater_pid_kp, app_state.settings.heater_pid_ti, app_state.settings.heater_pid_td, app_state.settings.heater_pid_i_clamp, app_state.settings.heater_pid_offset, app_state.settings.heater_pid_d_smoothing_factor,  HEATER_CONTROL_MIN, HEATER_CONTROL_MAX);
+		app_state.settings.heater_output_mode = (uint8_t)imax8(imin8((int8_t)app_state.settings.heater_output_mode + (app_state.current_input.rotenc_delta > 0 ? 1 : -1), HEATER_NUM_OUTPUT_MODES - 1), 0);
+		app_apply_heater_output_settings();
 	}
 	
 	// display current value
 	srd_clear();
-	mr_heater_menu_pid_p(app_state.settings.heater_pid_kp);
+	mr_heater_menu_output_mode(app_state.settings.heater_output_mode);
 	srd_display();
 	
 	if(app_state.current_input.button_presses & (1 << BUTTON0))
 	{
 		app_state.selected_menu_item_index = 1;
-		app_state.current_state_func = app_state_menu_heater_pid;
+		app_state.current_state_func = app_state_menu_heater_output;
 	}
 	return EC_SUCCESS;
 }
 
-ErrorCode app_state_menu_heater_pid_i()
+ErrorCode app_state_menu_heater_output_window()
 {
 	if(app_state.current_input.rotenc_delta != 0)
 	{
-		app_state.settings.heater_pid_ti = fmax(fmin(app_state.settings.heater_pid_ti + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_I), MIN_HEATER_PID_I);
-		pid_set_params(&app_state.pid_state, app_state.settings.heater_pid_kp, app_state.settings.heater_pid_ti, app_state.settings.heater_pid_td, app_state.settings.heater_pid_i_clamp, app_state.settings.heater_pid_offset, app_state.settings.heater_pid_d_smoothing_factor, HEATER_CONTROL_MIN, HEATER_CONTROL_MAX);
+		app_state.settings.heater_tprop_window = fmax(fmin(app_state.settings.heater_tprop_window + app_state.current_input.rotenc_delta * HEATER_TPROP_WINDOW_CHANGE_PER_ROTENC_STEP, MAX_HEATER_TPROP_WINDOW), MIN_HEATER_TPROP_WINDOW);
+		app_apply_heater_output_settings();
 	}
 	
 	// display current value
 	srd_clear();
-	mr_heater_menu_pid_i(app_state.settings.heater_pid_ti);
+	mr_heater_menu_pid_time(app_state.settings.heater_tprop_window);
 	srd_display();
 	
 	if(app_state.current_input.button_presses & (1 << BUTTON0))
 	{
 		app_state.selected_menu_item_index = 2;
-		app_state.current_state_func = app_state_menu_heater_pid;
+		app_state.current_state_func = app_state_menu_heater_output;
 	}
 	return EC_SUCCESS;
 }
 
-ErrorCode app_state_menu_heater_pid_d()
+ErrorCode app_state_menu_heater_eco()
 {
-	if(app_state.current_input.rotenc_delta != 0)
-	{
-		app_state.settings.heater_pid_td = fmax(fmin(app_state.settings.heater_pid_td + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_D), MIN_HEATER_PID_D);
-		pid_set_params(&app_state.pid_state, app_state.settings.heater_pid_kp, app_state.settings.heater_pid_ti, app_state.settings.heater_pid_td, app_state.settings.heater_pid_i_clamp, app_state.settings.heater_pid_offset, app_state.settings.heater_pid_d_smoothing_factor, HEATER_CONTROL_MIN, HEATER_CONTROL_MAX);
-	}
-	
-	// display current value
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 3), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 3), 0);
+	// display selected menu item
 	srd_clear();
-	mr_heater_menu_pid_d(app_state.settings.heater_pid_td);
+	mr_heater_menu_eco(app_state.selected_menu_item_index);
 	srd_display();
 	
+	// state change
 	if(app_state.current_input.button_presses & (1 << BUTTON0))
 	{
-		app_state.selected_menu_item_index = 3;
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to heater menu
+				app_state.selected_menu_item_index = 6;
+				app_state.current_state_func = app_state_menu_heater;
+				break;
+			case 1: // eco standby on / off
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_eco_onoff;
+				break;
+			case 2:	// idle timeout
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_eco_timeout;
+				break;
+			case 3:	// standby temp
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_eco_temp;
+				break;
+		}
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_eco_onoff()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+		app_state.settings.eco_onoff = !app_state.settings.eco_onoff;
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_onoff(app_state.settings.eco_onoff);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 1;
+		app_state.current_state_func = app_state_menu_heater_eco;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_eco_timeout()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+		app_state.settings.eco_timeout = (uint16_t)imax16(imin16((int16_t)app_state.settings.eco_timeout + app_state.current_input.rotenc_delta * ECO_TIMEOUT_CHANGE_PER_ROTENC_STEP, MAX_ECO_TIMEOUT), MIN_ECO_TIMEOUT);
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_eco_timeout(app_state.settings.eco_timeout);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 2;
+		app_state.current_state_func = app_state_menu_heater_eco;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_eco_temp()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+		app_state.settings.eco_temp = fmax(fmin(app_state.settings.eco_temp + app_state.current_input.rotenc_delta * TEMP_CHANGE_PER_ROTENC_STEP, MAX_HEATER_TARGET_TEMP), MIN_HEATER_TARGET_TEMP);
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_target_temp(app_state.settings.eco_temp);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 3;
+		app_state.current_state_func = app_state_menu_heater_eco;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid()
+{
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 14), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 14), 0);
+	// display selected menu item
+	srd_clear();
+	mr_heater_menu_pid(app_state.selected_menu_item_index);
+	srd_display();
+	
+	// state change
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to main menu
+				app_state.selected_menu_item_index = 4;
+				app_state.current_state_func = app_state_menu_heater;
+				break;
+			case 1: // P
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_p;
+				break;
+			case 2:	// I
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_i;
+				break;
+			case 3:	// D
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_d;
+				break;
+			case 4:	// I-CLAMP
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_i_clamp;
+				break;
+			case 5:	// OFFSET
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_offset;
+				break;
+			case 6:	// D FILTER
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_d_filter;
+				break;
+			case 7:	// SET POINT WEIGHT P
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_sp_weight_p;
+				break;
+			case 8:	// SET POINT WEIGHT D
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_sp_weight_d;
+				break;
+			case 9:	// SET POINT FILTER
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_sp_filter_tc;
+				break;
+			case 10: // GAIN SCHEDULING
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_gs;
+				break;
+			case 11: // SMITH PREDICTOR
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_smith;
+				break;
+			case 12: // DISTURBANCE OBSERVER
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_dob;
+				break;
+			case 13: // VELOCITY FORM
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_velocity_onoff;
+				break;
+			case 14: // EXPLICIT MPC
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_mpc_onoff;
+				break;
+		}
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_p()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.heater_pid_kp = fmax(fmin(app_state.settings.heater_pid_kp + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_P), MIN_HEATER_PID_P);
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_p(app_state.settings.heater_pid_kp);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 1;
+		app_state.current_state_func = app_state_menu_heater_pid;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_i()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.heater_pid_ti = fmax(fmin(app_state.settings.heater_pid_ti + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_I), MIN_HEATER_PID_I);
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_i(app_state.settings.heater_pid_ti);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 2;
+		app_state.current_state_func = app_state_menu_heater_pid;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_d()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.heater_pid_td = fmax(fmin(app_state.settings.heater_pid_td + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_D), MIN_HEATER_PID_D);
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_d(app_state.settings.heater_pid_td);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 3;
 		app_state.current_state_func = app_state_menu_heater_pid;
 	}
 	return EC_SUCCESS;
@@ -791,7 +1547,7 @@ ErrorCode app_state_menu_heater_pid_i_clamp()
 	if(app_state.current_input.rotenc_delta != 0)
 	{
 		app_state.settings.heater_pid_i_clamp = fmax(fmin(app_state.settings.heater_pid_i_clamp + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_I_CLAMP), MIN_HEATER_PID_I_CLAMP);
-		pid_set_params(&app_state.pid_state, app_state.settings.heater_pid_kp, app_state.settings.heater_pid_ti, app_state.settings.heater_pid_td, app_state.settings.heater_pid_i_clamp, app_state.settings.heater_pid_offset, app_state.settings.heater_pid_d_smoothing_factor, HEATER_CONTROL_MIN, HEATER_CONTROL_MAX);
+		app_apply_pid_settings();
 	}
 	
 	// display current value
@@ -812,7 +1568,7 @@ ErrorCode app_state_menu_heater_pid_offset()
 	if(app_state.current_input.rotenc_delta != 0)
 	{
 		app_state.settings.heater_pid_offset = fmax(fmin(app_state.settings.heater_pid_offset + app_state.current_input.rotenc_delta * TEMP_CHANGE_PER_ROTENC_STEP, MAX_HEATER_OFFSET), MIN_HEATER_OFFSET);
-		pid_set_params(&app_state.pid_state, app_state.settings.heater_pid_kp, app_state.settings.heater_pid_ti, app_state.settings.heater_pid_td, app_state.settings.heater_pid_i_clamp, app_state.settings.heater_pid_offset, app_state.settings.heater_pid_d_smoothing_factor, HEATER_CONTROL_MIN, HEATER_CONTROL_MAX);
+		app_apply_pid_settings();
 	}
 	
 	// display current value
@@ -828,153 +1584,1149 @@ ErrorCode app_state_menu_heater_pid_offset()
 	return EC_SUCCESS;
 }
 
-ErrorCode app_state_menu_heater_pid_d_smoothing_factor()
+ErrorCode app_state_menu_heater_pid_d_filter()
+{
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 2), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 2), 0);
+	// display selected menu item
+	srd_clear();
+	mr_heater_menu_pid_d_filter(app_state.selected_menu_item_index);
+	srd_display();
+	
+	// state change
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to pid menu
+				app_state.selected_menu_item_index = 6;
+				app_state.current_state_func = app_state_menu_heater_pid;
+				break;
+			case 1: // cutoff frequency
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_d_filter_cutoff;
+				break;
+			case 2: // quality factor
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_d_filter_q;
+				break;
+		}
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_d_filter_cutoff()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.heater_pid_d_filter_cutoff = fmax(fmin(app_state.settings.heater_pid_d_filter_cutoff * pow(PID_D_FILTER_CUTOFF_FACTOR_PER_ROTENC_STEP, app_state.current_input.rotenc_delta), MAX_HEATER_PID_D_FILTER_CUTOFF), MIN_HEATER_PID_D_FILTER_CUTOFF);
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_d_filter_param(app_state.settings.heater_pid_d_filter_cutoff);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 1;
+		app_state.current_state_func = app_state_menu_heater_pid_d_filter;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_d_filter_q()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.heater_pid_d_filter_q = fmax(fmin(app_state.settings.heater_pid_d_filter_q + app_state.current_input.rotenc_delta * PID_FINE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_D_FILTER_Q), MIN_HEATER_PID_D_FILTER_Q);
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_d_filter_param(app_state.settings.heater_pid_d_filter_q);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 2;
+		app_state.current_state_func = app_state_menu_heater_pid_d_filter;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_sp_weight_p()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.heater_pid_sp_weight_p = fmax(fmin(app_state.settings.heater_pid_sp_weight_p + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_SP_WEIGHT), MIN_HEATER_PID_SP_WEIGHT);
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_sp_weight(app_state.settings.heater_pid_sp_weight_p);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 7;
+		app_state.current_state_func = app_state_menu_heater_pid;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_sp_weight_d()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.heater_pid_sp_weight_d = fmax(fmin(app_state.settings.heater_pid_sp_weight_d + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_SP_WEIGHT), MIN_HEATER_PID_SP_WEIGHT);
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_sp_weight(app_state.settings.heater_pid_sp_weight_d);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 8;
+		app_state.current_state_func = app_state_menu_heater_pid;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_sp_filter_tc()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.heater_pid_sp_filter_tc = fmax(fmin(app_state.settings.heater_pid_sp_filter_tc + app_state.current_input.rotenc_delta * TEMP_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_SP_FILTER_TC), MIN_HEATER_PID_SP_FILTER_TC);
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_sp_filter_tc(app_state.settings.heater_pid_sp_filter_tc);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 9;
+		app_state.current_state_func = app_state_menu_heater_pid;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_gs()
+{
+	// "--", "ONOFF" and one entry per band and gain of the currently controlling probe
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 1 + HEATER_GS_NUM_BANDS * 3), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 1 + HEATER_GS_NUM_BANDS * 3), 0);
+	// display selected menu item
+	srd_clear();
+	mr_heater_menu_pid_gs(app_state.selected_menu_item_index);
+	srd_display();
+	
+	// state change
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to pid menu
+				app_state.selected_menu_item_index = 10;
+				app_state.current_state_func = app_state_menu_heater_pid;
+				break;
+			case 1: // gain scheduling on / off
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_gs_onoff;
+				break;
+			default: // gain table entry
+				app_state.menu_edit_index = (uint8_t)(app_state.selected_menu_item_index - 2);
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_gs_entry;
+				break;
+		}
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_gs_onoff()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.heater_pid_gs_onoff = !app_state.settings.heater_pid_gs_onoff;
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_onoff(app_state.settings.heater_pid_gs_onoff);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 1;
+		app_state.current_state_func = app_state_menu_heater_pid_gs;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_gs_entry()
+{
+	// menu_edit_index = band * 3 + gain
+	pid_gains_t* entry = &app_state.settings.heater_pid_gain_table[app_state.settings.controlling_tprobe][app_state.menu_edit_index / 3];
+	float* value;
+	float value_min, value_max;
+	switch(app_state.menu_edit_index % 3)
+	{
+		case 0:
+			value = &entry->Kp; value_min = MIN_HEATER_PID_P; value_max = MAX_HEATER_PID_P;
+			break;
+		case 1:
+			value = &entry->Ti; value_min = MIN_HEATER_PID_I; value_max = MAX_HEATER_PID_I;
+			break;
+		default:
+			value = &entry->Td; value_min = MIN_HEATER_PID_D; value_max = MAX_HEATER_PID_D;
+			break;
+	}
+	
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		*value = fmax(fmin(*value + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, value_max), value_min);
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_p(*value);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = (int8_t)(app_state.menu_edit_index + 2);
+		app_state.current_state_func = app_state_menu_heater_pid_gs;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_smith()
+{
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 3), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 3), 0);
+	// display selected menu item
+	srd_clear();
+	mr_heater_menu_pid_smith(app_state.selected_menu_item_index);
+	srd_display();
+	
+	// state change
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to pid menu
+				app_state.selected_menu_item_index = 11;
+				app_state.current_state_func = app_state_menu_heater_pid;
+				break;
+			case 1: // smith predictor on / off
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_smith_onoff;
+				break;
+			case 2: // model time constant
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_smith_tau;
+				break;
+			case 3: // model dead time
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_smith_dead_time;
+				break;
+		}
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_smith_onoff()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+		app_state.settings.heater_smith_onoff = !app_state.settings.heater_smith_onoff;
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_onoff(app_state.settings.heater_smith_onoff);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 1;
+		app_state.current_state_func = app_state_menu_heater_pid_smith;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_smith_tau()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.heater_model_tau = fmax(fmin(app_state.settings.heater_model_tau + app_state.current_input.rotenc_delta * TIME_CHANGE_PER_ROTENC_STEP, MAX_HEATER_MODEL_TAU), MIN_HEATER_MODEL_TAU);
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_time(app_state.settings.heater_model_tau);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 2;
+		app_state.current_state_func = app_state_menu_heater_pid_smith;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_smith_dead_time()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.heater_model_dead_time = fmax(fmin(app_state.settings.heater_model_dead_time + app_state.current_input.rotenc_delta * TIME_CHANGE_PER_ROTENC_STEP, MAX_HEATER_MODEL_DEAD_TIME), MIN_HEATER_MODEL_DEAD_TIME);
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_time(app_state.settings.heater_model_dead_time);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 3;
+		app_state.current_state_func = app_state_menu_heater_pid_smith;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_dob()
+{
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 2), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 2), 0);
+	// display selected menu item
+	srd_clear();
+	mr_heater_menu_pid_dob(app_state.selected_menu_item_index);
+	srd_display();
+	
+	// state change
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to pid menu
+				app_state.selected_menu_item_index = 12;
+				app_state.current_state_func = app_state_menu_heater_pid;
+				break;
+			case 1: // disturbance observer on / off
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_dob_onoff;
+				break;
+			case 2: // compensation threshold
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_heater_pid_dob_threshold;
+				break;
+		}
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_dob_onoff()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+		app_state.settings.heater_dob_onoff = !app_state.settings.heater_dob_onoff;
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_onoff(app_state.settings.heater_dob_onoff);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 1;
+		app_state.current_state_func = app_state_menu_heater_pid_dob;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_dob_threshold()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+		app_state.settings.heater_dob_threshold = fmax(fmin(app_state.settings.heater_dob_threshold + app_state.current_input.rotenc_delta * DUTY_CYCLE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_DOB_THRESHOLD), MIN_HEATER_DOB_THRESHOLD);
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_dob_threshold(app_state.settings.heater_dob_threshold);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 2;
+		app_state.current_state_func = app_state_menu_heater_pid_dob;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_velocity_onoff()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.heater_pid_velocity_onoff = !app_state.settings.heater_pid_velocity_onoff;
+		app_apply_pid_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_onoff(app_state.settings.heater_pid_velocity_onoff);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 13;
+		app_state.current_state_func = app_state_menu_heater_pid;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_heater_pid_mpc_onoff()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+		app_state.settings.heater_mpc_onoff = !app_state.settings.heater_mpc_onoff;
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_onoff(app_state.settings.heater_mpc_onoff);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 14;
+		app_state.current_state_func = app_state_menu_heater_pid;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_stirrer()
+{
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 4), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 4), 0);
+	// display selected menu item
+	srd_clear();
+	mr_stirrer_menu(app_state.selected_menu_item_index);
+	srd_display();
+	
+	// state change
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to main menu
+				app_state.selected_menu_item_index = 2;
+				app_state.current_state_func = app_state_menu_main;
+				break;
+			case 1: // stirrer duty cycle
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_stirrer_duty_cycle;
+				break;
+			case 2: // agitation waveform
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_stirrer_waveform;
+				break;
+			case 3: // waveform period
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_stirrer_period;
+				break;
+			case 4: // modulation depth
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_stirrer_depth;
+				break;
+		}
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_stirrer_duty_cycle()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+		app_set_stirrer_duty_cycle((uint8_t)imax16(imin16((int16_t)app_state.stirrer_duty_cycle + app_state.current_input.rotenc_delta * STIRRER_DC_CHANGE_PER_STEP, 100), 0));
+	
+	// display current value
+	srd_clear();
+	mr_stirrer_menu_dc(app_state.stirrer_duty_cycle);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 1;
+		app_state.current_state_func = app_state_menu_stirrer;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_stirrer_waveform()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.stirrer_waveform = (uint8_t)imax8(imin8((int8_t)app_state.settings.stirrer_waveform + (app_state.current_input.rotenc_delta > 0 ? 1 : -1), AGT_NUM_WAVES - 1), 0);
+		app_apply_stirrer_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_stirrer_menu_waveform(app_state.settings.stirrer_waveform);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 2;
+		app_state.current_state_func = app_state_menu_stirrer;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_stirrer_period()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.stirrer_period = fmax(fmin(app_state.settings.stirrer_period + app_state.current_input.rotenc_delta * STIRRER_PERIOD_CHANGE_PER_ROTENC_STEP, MAX_STIRRER_PERIOD), MIN_STIRRER_PERIOD);
+		app_apply_stirrer_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_pid_time(app_state.settings.stirrer_period);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 3;
+		app_state.current_state_func = app_state_menu_stirrer;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_stirrer_depth()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.stirrer_depth = (uint8_t)imax16(imin16((int16_t)app_state.settings.stirrer_depth + app_state.current_input.rotenc_delta * STIRRER_DEPTH_CHANGE_PER_ROTENC_STEP, MAX_STIRRER_DEPTH), MIN_STIRRER_DEPTH);
+		app_apply_stirrer_settings();
+	}
+	
+	// display current value
+	srd_clear();
+	mr_stirrer_menu_dc(app_state.settings.stirrer_depth);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 4;
+		app_state.current_state_func = app_state_menu_stirrer;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_fan()
+{
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, APP_FAN_MENU_LAST_ITEM), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, APP_FAN_MENU_LAST_ITEM), 0);
+	// display selected menu item
+	srd_clear();
+	mr_fan_menu(app_state.selected_menu_item_index);
+	srd_display();
+	
+	// state change
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to main menu
+				app_state.selected_menu_item_index = 3;
+				app_state.current_state_func = app_state_menu_main;
+				break;
+			case 1: // fan duty cycle
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_fan_duty_cycle;
+				break;
+			case 2: // automatic fan curve
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_fan_curve_onoff;
+				break;
+			case 3: // fan curve idle speed
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_fan_idle_duty_cycle;
+				break;
+			case 4: // closed loop speed control
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_fan_closed_loop_onoff;
+				break;
+			case 5: // measured speed
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_fan_rpm;
+				break;
+		}
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_fan_duty_cycle()
+{
+	// full load speed of the fan curve or fixed speed
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.fan_duty_cycle = (uint8_t)imax16(imin16((int16_t)app_state.settings.fan_duty_cycle + app_state.current_input.rotenc_delta * STIRRER_DC_CHANGE_PER_STEP, 100), 0);
+		if(!app_state.settings.fan_curve_onoff)
+			app_set_fan_duty_cycle(app_state.settings.fan_duty_cycle);
+	}
+	
+	// display current value
+	srd_clear();
+	mr_fan_menu_dc(app_state.settings.fan_duty_cycle);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 1;
+		app_state.current_state_func = app_state_menu_fan;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_fan_curve_onoff()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.fan_curve_onoff = !app_state.settings.fan_curve_onoff;
+		// the curve starts at the current speed, the fixed speed applies at once
+		if(app_state.settings.fan_curve_onoff)
+			fcurve_init(&app_state.fan_curve_state, app_state.fan_duty_cycle);
+		else
+			app_set_fan_duty_cycle(app_state.settings.fan_duty_cycle);
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_onoff(app_state.settings.fan_curve_onoff);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 2;
+		app_state.current_state_func = app_state_menu_fan;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_fan_idle_duty_cycle()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+		app_state.settings.fan_idle_duty_cycle = (uint8_t)imax16(imin16((int16_t)app_state.settings.fan_idle_duty_cycle + app_state.current_input.rotenc_delta * STIRRER_DC_CHANGE_PER_STEP, 100), 0);
+	
+	// display current value
+	srd_clear();
+	mr_fan_menu_dc(app_state.settings.fan_idle_duty_cycle);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 3;
+		app_state.current_state_func = app_state_menu_fan;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_fan_closed_loop_onoff()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		app_state.settings.fan_closed_loop_onoff = !app_state.settings.fan_closed_loop_onoff;
+		fctl_reset(&app_state.fan_control_state);
+		// back to the open loop duty cycle
+		if(!app_state.settings.fan_closed_loop_onoff)
+			fan_set_duty_cycle(app_state.fan_duty_cycle);
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_onoff(app_state.settings.fan_closed_loop_onoff);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 4;
+		app_state.current_state_func = app_state_menu_fan;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_fan_rpm()
+{
+	// display measured speed
+	srd_clear();
+	mr_fan_menu_rpm(app_state.fan_control_state.rpm);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 5;
+		app_state.current_state_func = app_state_menu_fan;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_recipe()
+{
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, RCP_MAX_SEGMENTS + 1), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, RCP_MAX_SEGMENTS + 1), 0);
+	// display selected menu item
+	srd_clear();
+	mr_recipe_menu(app_state.selected_menu_item_index);
+	srd_display();
+	
+	// state change
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to main menu, keep the edited recipe
+				app_store_recipe_to_eeprom();
+				app_state.selected_menu_item_index = 7;
+				app_state.current_state_func = app_state_menu_main;
+				break;
+			case 1: // start / stop
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_recipe_run;
+				break;
+			default: // segments
+				app_state.menu_edit_index = (uint8_t)(app_state.selected_menu_item_index - 2);
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_recipe_segment;
+				break;
+		}
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_recipe_run()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		if(app_state.recipe_state.running)
+		{
+			rcp_stop(&app_state.recipe_state);
+		}
+		else
+		{
+			// ramps start at the current bath temperature
+			app_set_heater_onoff(TRUE);
+			rcp_start(&app_state.recipe_state, app_state.process_value);
+		}
+	}
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_onoff(app_state.recipe_state.running);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 1;
+		app_state.current_state_func = app_state_menu_recipe;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_recipe_segment()
+{
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 3), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 3), 0);
+	// display selected menu item
+	srd_clear();
+	mr_recipe_segment_menu(app_state.selected_menu_item_index);
+	srd_display();
+	
+	// state change
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to recipe menu
+				app_state.selected_menu_item_index = (int8_t)(app_state.menu_edit_index + 2);
+				app_state.current_state_func = app_state_menu_recipe;
+				break;
+			case 1: // segment type
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_recipe_segment_type;
+				break;
+			case 2: // value
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_recipe_segment_value;
+				break;
+			case 3: // argument
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_recipe_segment_arg;
+				break;
+		}
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_recipe_segment_type()
+{
+	rcp_segment_t* seg = &app_state.recipe[app_state.menu_edit_index];
+	if(app_state.current_input.rotenc_delta != 0)
+		seg->type = (uint8_t)imax16(imin16((int16_t)seg->type + app_state.current_input.rotenc_delta, RCP_NUM_SEG_TYPES - 1), 0);
+	
+	// display current value
+	srd_clear();
+	mr_recipe_segment_type(seg->type);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 1;
+		app_state.current_state_func = app_state_menu_recipe_segment;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_recipe_segment_value()
+{
+	rcp_segment_t* seg = &app_state.recipe[app_state.menu_edit_index];
+	// ramp target temperature in 0.1 degC or hold time in seconds
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		if(seg->type == RCP_SEG_RAMP)
+			seg->value = (uint16_t)fmax(fmin(seg->value + app_state.current_input.rotenc_delta * TEMP_CHANGE_PER_ROTENC_STEP * 10.0, MAX_HEATER_TARGET_TEMP * 10.0), MIN_HEATER_TARGET_TEMP * 10.0);
+		else
+			seg->value = (uint16_t)fmax(fmin((float)seg->value + app_state.current_input.rotenc_delta * RCP_HOLD_CHANGE_PER_ROTENC_STEP, INT16_MAX), 0.0);
+	}
+	
+	// display current value
+	srd_clear();
+	if(seg->type == RCP_SEG_RAMP)
+		mr_recipe_segment_value(seg->value * 0.1, 1);
+	else
+		mr_recipe_segment_value(seg->value, 0);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 2;
+		app_state.current_state_func = app_state_menu_recipe_segment;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_recipe_segment_arg()
+{
+	rcp_segment_t* seg = &app_state.recipe[app_state.menu_edit_index];
+	// ramp rate in 0.1 K/min or stirrer duty cycle
+	if(app_state.current_input.rotenc_delta != 0)
+		seg->arg = (uint8_t)imax16(imin16((int16_t)seg->arg + app_state.current_input.rotenc_delta, seg->type == RCP_SEG_STIRRER ? 100 : UINT8_MAX), 0);
+	
+	// display current value
+	srd_clear();
+	if(seg->type == RCP_SEG_RAMP)
+		mr_recipe_segment_value(seg->arg * 0.1, 1);
+	else
+		mr_recipe_segment_value(seg->arg, 0);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 3;
+		app_state.current_state_func = app_state_menu_recipe_segment;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_stats()
+{
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, APP_STATS_LAST_PAGE), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, APP_STATS_LAST_PAGE), 0);
+	
+	// display current page
+	srd_clear();
+	if(app_state.selected_menu_item_index < 6)
+	{
+		// session pages first, then the lifetime pages
+		const egy_counter_t* counter = app_state.selected_menu_item_index < 3 ? &app_state.energy_state.session : &app_state.energy_state.lifetime;
+		float value;
+		switch(app_state.selected_menu_item_index % 3)
+		{
+			case 0: // lifetime energy in kWh
+				value = app_state.selected_menu_item_index < 3 ? egy_energy_wh(counter) : egy_energy_wh(counter) * 0.001;
+				break;
+			case 1:
+				value = egy_on_time_hours(counter);
+				break;
+			default:
+				value = egy_average_duty_cycle(counter);
+				break;
+		}
+		mr_stats(app_state.selected_menu_item_index, value);
+	}
+	else if(app_state.selected_menu_item_index == 6)
+	{
+		mr_fault_count(app_state.fault_count);
+	}
+	else
+	{
+		// fault history, newest first
+		const app_fault_t* fault = app_get_fault(app_state.selected_menu_item_index - 7);
+		uint32_t age = (uint32_t)appt_cycles_to_seconds(appt_get_cycles_since_startup()) - fault->time;
+		mr_fault(fault->error, fault->probe, (uint16_t)umin32(age / 60, 999));
+	}
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 8;
+		app_state.current_state_func = app_state_menu_main;
+	}
+	return EC_SUCCESS;
+}
+
+#if HEATER_NUM_ZONES > 1
+ErrorCode app_state_menu_zone()
+{
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, HEATER_NUM_ZONES - 1), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, HEATER_NUM_ZONES - 1), 0);
+	// display selected menu item
+	srd_clear();
+	mr_zone_menu(app_state.selected_menu_item_index);
+	srd_display();
+	
+	// state change
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to main menu
+				app_state.selected_menu_item_index = 9;
+				app_state.current_state_func = app_state_menu_main;
+				break;
+			default: // zones, menu item n is heater zone n
+				app_state.menu_edit_index = (uint8_t)(app_state.selected_menu_item_index - 1);
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_zone_edit;
+				break;
+		}
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_zone_edit()
+{
+	if(app_state.current_input.rotenc_delta > 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 6), 0);
+	else if(app_state.current_input.rotenc_delta < 0)
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 6), 0);
+	// display selected menu item
+	srd_clear();
+	mr_zone_edit_menu(app_state.selected_menu_item_index);
+	srd_display();
+	
+	// state change
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		switch(app_state.selected_menu_item_index)
+		{
+			case 0:	// back to zones menu
+				app_state.selected_menu_item_index = (int8_t)(app_state.menu_edit_index + 1);
+				app_state.current_state_func = app_state_menu_zone;
+				break;
+			case 1: // zone on / off
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_zone_onoff;
+				break;
+			case 2:	// zone target temp
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_zone_target_temp;
+				break;
+			case 3:	// thermistor select
+				app_state.selected_menu_item_index = app_state.settings.zones[app_state.menu_edit_index].controlling_tprobe;
+				app_state.current_state_func = app_state_menu_zone_controlling_tprobe;
+				break;
+			case 4:	// pid gains
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_zone_pid_p;
+				break;
+			case 5:
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_zone_pid_i;
+				break;
+			case 6:
+				app_state.selected_menu_item_index = 0;
+				app_state.current_state_func = app_state_menu_zone_pid_d;
+				break;
+		}
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_zone_onoff()
+{
+	if(app_state.current_input.rotenc_delta != 0)
+		app_set_zone_onoff(app_state.menu_edit_index, !app_state.zones[app_state.menu_edit_index].onoff);
+	
+	// display current value
+	srd_clear();
+	mr_heater_menu_onoff(app_state.zones[app_state.menu_edit_index].onoff);
+	srd_display();
+	
+	if(app_state.current_input.button_presses & (1 << BUTTON0))
+	{
+		app_state.selected_menu_item_index = 1;
+		app_state.current_state_func = app_state_menu_zone_edit;
+	}
+	return EC_SUCCESS;
+}
+
+ErrorCode app_state_menu_zone_target_temp()
 {
+	app_zone_settings_t* settings = &app_state.settings.zones[app_state.menu_edit_index];
 	if(app_state.current_input.rotenc_delta != 0)
-	{
-		app_state.settings.heater_pid_d_smoothing_factor = fmax(fmin(app_state.settings.heater_pid_d_smoothing_factor + app_state.current_input.rotenc_delta * PID_FINE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_D_SMOOTHING_FACTOR), MIN_HEATER_PID_D_SMOOTHING_FACTOR);
-		pid_set_params(&app_state.pid_state, app_state.settings.heater_pid_kp, app_state.settings.heater_pid_ti, app_state.settings.heater_pid_td, app_state.settings.heater_pid_i_clamp, app_state.settings.heater_pid_offset, app_state.settings.heater_pid_d_smoothing_factor, HEATER_CONTROL_MIN, HEATER_CONTROL_MAX);
-	}
+		settings->target_temp = fmax(fmin(settings->target_temp + app_state.current_input.rotenc_delta * TEMP_CHANGE_PER_ROTENC_STEP, MAX_HEATER_TARGET_TEMP), MIN_HEATER_TARGET_TEMP);
 	
 	// display current value
 	srd_clear();
-	mr_heater_menu_pid_dsmooth(app_state.settings.heater_pid_d_smoothing_factor);
+	mr_heater_menu_target_temp(settings->target_temp);
 	srd_display();
 	
 	if(app_state.current_input.button_presses & (1 << BUTTON0))
 	{
-		app_state.selected_menu_item_index = 6;
-		app_state.current_state_func = app_state_menu_heater_pid;
+		app_state.selected_menu_item_index = 2;
+		app_state.current_state_func = app_state_menu_zone_edit;
 	}
 	return EC_SUCCESS;
 }
 
-ErrorCode app_state_menu_stirrer()
+ErrorCode app_state_menu_zone_controlling_tprobe()
 {
 	if(app_state.current_input.rotenc_delta > 0)
-		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 1), 0);
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 3), 0);
 	else if(app_state.current_input.rotenc_delta < 0)
-		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 1), 0);
-	// display selected menu item
+		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 3), 0);
+	
+	float temp;
+	uint8_t selection_valid = app_get_probe_temp((uint8_t)app_state.selected_menu_item_index, &temp);
+	
+	// display current selection
 	srd_clear();
-	mr_stirrer_menu(app_state.selected_menu_item_index);
+	mr_heater_menu_controlling_probe_select(app_state.selected_menu_item_index, selection_valid);
 	srd_display();
 	
-	// state change
 	if(app_state.current_input.button_presses & (1 << BUTTON0))
 	{
-		switch(app_state.selected_menu_item_index)
+		if(selection_valid)
 		{
-			case 0:	// back to main menu
-				app_state.selected_menu_item_index = 2;
-				app_state.current_state_func = app_state_menu_main;
-				break;
-			case 1: // heater duty cycle
-				app_state.selected_menu_item_index = 0;
-				app_state.current_state_func = app_state_menu_stirrer_duty_cycle;
-				break;
+			app_zone_state_t* zone = &app_state.zones[app_state.menu_edit_index];
+			app_state.settings.zones[app_state.menu_edit_index].controlling_tprobe = (uint8_t)app_state.selected_menu_item_index;
+			// continue from the current output on the new process value
+			pid_track(&zone->pid_state, temp, zone->pid_state.output);
+			zone->rapid_heating = FALSE;
+			app_state.selected_menu_item_index = 3;
+			app_state.current_state_func = app_state_menu_zone_edit;
 		}
 	}
 	return EC_SUCCESS;
 }
 
-ErrorCode app_state_menu_stirrer_duty_cycle()
+ErrorCode app_state_menu_zone_pid_p()
 {
+	pid_gains_t* gains = &app_state.settings.zones[app_state.menu_edit_index].gains;
 	if(app_state.current_input.rotenc_delta != 0)
 	{
-		app_state.stirrer_duty_cycle = (uint8_t)imax16(imin16((int16_t)app_state.stirrer_duty_cycle + app_state.current_input.rotenc_delta * STIRRER_DC_CHANGE_PER_STEP, 100), 0);
-		
-		if(!app_state.stirrer_onoff && app_state.stirrer_duty_cycle > 0) // stirrer was switched on
-		{
-			stirrer_on();
-		}
-		else if(app_state.stirrer_onoff && (app_state.stirrer_duty_cycle == 0)) // stirrer was switched off
-		{
-			stirrer_off();
-		}
-			
-		app_state.stirrer_onoff = app_state.stirrer_duty_cycle > 0;
-		
-		// set stirrer duty cycle
-		stirrer_set_duty_cycle(app_state.stirrer_duty_cycle);
+		gains->Kp = fmax(fmin(gains->Kp + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_P), MIN_HEATER_PID_P);
+		app_apply_zone_settings(app_state.menu_edit_index);
 	}
 	
 	// display current value
 	srd_clear();
-	mr_stirrer_menu_dc(app_state.stirrer_duty_cycle);
+	mr_heater_menu_pid_p(gains->Kp);
 	srd_display();
 	
 	if(app_state.current_input.button_presses & (1 << BUTTON0))
 	{
-		app_state.selected_menu_item_index = 1;
-		app_state.current_state_func = app_state_menu_stirrer;
+		app_state.selected_menu_item_index = 4;
+		app_state.current_state_func = app_state_menu_zone_edit;
 	}
 	return EC_SUCCESS;
 }
 
-ErrorCode app_state_menu_fan()
+ErrorCode app_state_menu_zone_pid_i()
 {
-	if(app_state.current_input.rotenc_delta > 0)
-		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index + 1, 1), 0);
-	else if(app_state.current_input.rotenc_delta < 0)
-		app_state.selected_menu_item_index = imax8(imin8(app_state.selected_menu_item_index - 1, 1), 0);
-	// display selected menu item
+	pid_gains_t* gains = &app_state.settings.zones[app_state.menu_edit_index].gains;
+	if(app_state.current_input.rotenc_delta != 0)
+	{
+		gains->Ti = fmax(fmin(gains->Ti + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_I), MIN_HEATER_PID_I);
+		app_apply_zone_settings(app_state.menu_edit_index);
+	}
+	
+	// display current value
 	srd_clear();
-	mr_fan_menu(app_state.selected_menu_item_index);
+	mr_heater_menu_pid_i(gains->Ti);
 	srd_display();
 	
-	// state change
 	if(app_state.current_input.button_presses & (1 << BUTTON0))
 	{
-		switch(app_state.selected_menu_item_index)
-		{
-			case 0:	// back to main menu
-				app_state.selected_menu_item_index = 3;
-				app_state.current_state_func = app_state_menu_main;
-				break;
-			case 1: // heater duty cycle
-				app_state.selected_menu_item_index = 0;
-				app_state.current_state_func = app_state_menu_fan_duty_cycle;
-				break;
-		}
+		app_state.selected_menu_item_index = 5;
+		app_state.current_state_func = app_state_menu_zone_edit;
 	}
 	return EC_SUCCESS;
 }
 
-ErrorCode app_state_menu_fan_duty_cycle()
+ErrorCode app_state_menu_zone_pid_d()
 {
+	pid_gains_t* gains = &app_state.settings.zones[app_state.menu_edit_index].gains;
 	if(app_state.current_input.rotenc_delta != 0)
 	{
-		app_state.fan_duty_cycle = (uint8_t)imax16(imin16((int16_t)app_state.fan_duty_cycle + app_state.current_input.rotenc_delta * STIRRER_DC_CHANGE_PER_STEP, 100), 0);
-		app_state.settings.fan_duty_cycle = app_state.fan_duty_cycle;
-		
-		if(!app_state.fan_onoff && app_state.fan_duty_cycle > 0) // fan was switched on
-		{
-			fan_on();
-		}
-		else if(app_state.fan_onoff && (app_state.fan_duty_cycle == 0)) // fan was switched off
-		{
-			fan_off();
-		}
-		
-		app_state.fan_onoff = app_state.fan_duty_cycle > 0;
-		
-		// set fan duty cycle
-		fan_set_duty_cycle(app_state.fan_duty_cycle);
+		gains->Td = fmax(fmin(gains->Td + app_state.current_input.rotenc_delta * PID_COARSE_CHANGE_PER_ROTENC_STEP, MAX_HEATER_PID_D), MIN_HEATER_PID_D);
+		app_apply_zone_settings(app_state.menu_edit_index);
 	}
 	
 	// display current value
 	srd_clear();
-	mr_fan_menu_dc(app_state.fan_duty_cycle);
+	mr_heater_menu_pid_d(gains->Td);
 	srd_display();
 	
 	if(app_state.current_input.button_presses & (1 << BUTTON0))
 	{
-		app_state.selected_menu_item_index = 1;
-		app_state.current_state_func = app_state_menu_fan;
+		app_state.selected_menu_item_index = 6;
+		app_state.current_state_func = app_state_menu_zone_edit;
 	}
 	return EC_SUCCESS;
 }
+#endif
 
 ErrorCode app_state_menu_tprobe()
 {
@@ -1145,6 +2897,160 @@ void app_error_display()
 	}
 }
 
+void app_handle_error(ErrorCode ec)
+{
+	uint8_t probe = app_get_fault_probe(ec);
+	const app_error_policy_t* policy = app_get_error_policy(ec, probe);
+	if(policy->action == APP_EP_LOG)
+	{
+		// auxiliary probe: recorded once per fault, control continues
+		if(app_state.probe_errors[probe] != ec)
+			app_record_fault(ec, probe);
+		app_state.probe_errors[probe] = ec;
+		app_state.current_error = EC_SUCCESS;
+		return;
+	}
+	
+	// a persisting fault is only recorded once
+	if(ec != app_state.degraded_error || probe != app_state.degraded_probe)
+		app_record_fault(ec, probe);
+	
+	if(policy->action == APP_EP_HALT)
+	{
+		app_state.current_error = ec;
+		app_state.should_stop = TRUE;
+		return;
+	}
+	// the error is handled, keep it from triggering the emergency shutdown
+	app_state.current_error = EC_SUCCESS;
+	
+	// fail-safe: heater and zones off, display, stirrer and fan keep running
+	if(!app_state.degraded_error)
+	{
+		heater_off();
+		app_state.heater_rapid_heating = FALSE;
+		// zones are switched on again when the fault clears
+		app_state.degraded_zones = 0;
+		#if HEATER_NUM_ZONES > 1
+			for(uint8_t i = 0; i < HEATER_NUM_ZONES - 1; ++i)
+			{
+				if(app_state.zones[i].onoff)
+					app_state.degraded_zones |= (1 << i);
+				app_set_zone_onoff(i, FALSE);
+			}
+		#endif
+	}
+	app_state.degraded_error = ec;
+	app_state.degraded_probe = probe;
+	app_state.degraded_good_ticks = 0;
+	if(policy->action == APP_EP_LATCH)
+		app_state.degraded_latched = TRUE;
+}
+
+uint8_t app_get_fault_probe(ErrorCode ec)
+{
+	// probe faults are rated by the role of the probe
+	if(ec == EC_THERMISTOR_OPEN_CIRCUIT || ec == EC_THERMISTOR_SHORT_CIRCUIT || ec == EC_THERMISTOR_MAX_TEMP
+		|| ec == EC_THERMISTOR_MIN_TEMP || ec == EC_THERMISTOR_IMPLAUSIBLE)
+		return app_state.error_probe;
+	return APP_NO_PROBE;
+}
+
+uint8_t app_check_probe_fault(ErrorCode ec)
+{
+	if(ec == EC_SUCCESS)
+	{
+		app_state.probe_errors[app_state.error_probe] = EC_SUCCESS;
+		return FALSE;
+	}
+	// logged faults of auxiliary probes keep the control step running
+	if(app_get_error_policy(ec, app_get_fault_probe(ec))->action != APP_EP_LOG)
+		return TRUE;
+	app_handle_error(ec);
+	return FALSE;
+}
+
+void app_record_fault(ErrorCode ec, uint8_t probe)
+{
+	app_fault_t* fault = &app_state.fault_history[app_state.fault_history_next];
+	fault->error = ec;
+	fault->probe = probe;
+	fault->time = (uint32_t)appt_cycles_to_seconds(appt_get_cycles_since_startup());
+	app_state.fault_history_next = (app_state.fault_history_next + 1) % APP_FAULT_HISTORY_SIZE;
+	app_state.fault_count = umin16(app_state.fault_count + 1, 9999);
+}
+
+const app_error_policy_t* app_get_error_policy(ErrorCode ec, uint8_t probe)
+{
+	if(ec >= sizeof(app_error_policies) / sizeof(app_error_policies[0]))
+		return &app_error_policy_halt;
+	uint8_t critical = probe == APP_NO_PROBE || probe == app_state.settings.controlling_tprobe || probe == HEATER_SAFETY_TPROBE;
+	#if HEATER_NUM_ZONES > 1
+		for(uint8_t i = 0; i < HEATER_NUM_ZONES - 1; ++i)
+			critical |= app_state.zones[i].onoff && probe == app_state.settings.zones[i].controlling_tprobe;
+	#endif
+	return &app_error_policies[ec][critical ? 0 : 1];
+}
+
+void app_clear_degraded()
+{
+	app_state.degraded_error = EC_SUCCESS;
+	app_state.degraded_latched = FALSE;
+	// heating continues, the pid tracked the process value meanwhile
+	if(app_state.heater_onoff)
+	{
+		eta_reset(&app_state.eta_state, app_state.process_value);
+		heater_on();
+	}
+	// zones switched off by the fault, the zone pids tracked meanwhile
+	#if HEATER_NUM_ZONES > 1
+		for(uint8_t i = 0; i < HEATER_NUM_ZONES - 1; ++i)
+		{
+			if(app_state.degraded_zones & (1 << i))
+				app_set_zone_onoff(i, TRUE);
+		}
+	#endif
+	app_state.degraded_zones = 0;
+}
+
+void app_acknowledge_fault()
+{
+	// a latched fault needs a new start of the heater and zones by the user
+	app_set_heater_onoff(FALSE);
+	app_state.degraded_zones = 0;
+	app_clear_degraded();
+}
+
+void app_stop_self_test_outputs()
+{
+	// heater back to its idle state, the user switches it on
+	heater_set_duty_cycle16(0);
+	heater_off();
+	// fan back to its setting, the fan update takes over again
+	#ifdef FAN_TACH
+		fan_set_duty_cycle(app_state.fan_duty_cycle);
+		if(app_state.fan_onoff)
+			fan_on();
+		else
+			fan_off();
+		fctl_reset(&app_state.fan_control_state);
+	#endif
+}
+
+void app_finish_self_test(uint8_t result, uint8_t probe)
+{
+	app_stop_self_test_outputs();
+	app_state.self_test_result = result;
+	app_state.self_test_probe = probe;
+	app_state.self_test_step = APP_SELF_TEST_STEP_RESULT;
+	app_state.self_test_start_time = appt_get_cycles_since_startup();
+}
+
+const app_fault_t* app_get_fault(uint8_t age_index)
+{
+	return &app_state.fault_history[(app_state.fault_history_next + APP_FAULT_HISTORY_SIZE - 1 - age_index) % APP_FAULT_HISTORY_SIZE];
+}
+
 void app_load_default_settings()
 {
 	app_state.settings.heater_target_temp = SETTINGS_DEFAULT_HEATER_TARGET_TEMP;
@@ -1153,15 +3059,126 @@ void app_load_default_settings()
 	app_state.settings.heater_pid_td = SETTINGS_DEFAULT_HEATER_PID_TD;
 	app_state.settings.heater_pid_i_clamp = SETTINGS_DEFAULT_HEATER_PID_I_CLAMP;
 	app_state.settings.heater_pid_offset = SETTINGS_DEFAULT_HEATER_PID_OFFSET;
-	app_state.settings.heater_pid_d_smoothing_factor = SETTINGS_DEFAULT_HEATER_PID_D_SMOOTHING_FACTOR;
+	app_state.settings.heater_pid_d_filter_cutoff = SETTINGS_DEFAULT_HEATER_PID_D_FILTER_CUTOFF;
+	app_state.settings.heater_pid_d_filter_q = SETTINGS_DEFAULT_HEATER_PID_D_FILTER_Q;
+	app_state.settings.heater_pid_sp_weight_p = SETTINGS_DEFAULT_HEATER_PID_SP_WEIGHT_P;
+	app_state.settings.heater_pid_sp_weight_d = SETTINGS_DEFAULT_HEATER_PID_SP_WEIGHT_D;
+	app_state.settings.heater_pid_sp_filter_tc = SETTINGS_DEFAULT_HEATER_PID_SP_FILTER_TC;
+	app_state.settings.heater_pid_velocity_onoff = SETTINGS_DEFAULT_HEATER_PID_VELOCITY_ONOFF;
+	app_state.settings.heater_pid_gs_onoff = SETTINGS_DEFAULT_HEATER_PID_GS_ONOFF;
+	app_state.settings.heater_smith_onoff = SETTINGS_DEFAULT_HEATER_SMITH_ONOFF;
+	app_state.settings.heater_model_tau = SETTINGS_DEFAULT_HEATER_MODEL_TAU;
+	app_state.settings.heater_model_dead_time = SETTINGS_DEFAULT_HEATER_MODEL_DEAD_TIME;
+	app_state.settings.heater_dob_onoff = SETTINGS_DEFAULT_HEATER_DOB_ONOFF;
+	app_state.settings.heater_dob_threshold = SETTINGS_DEFAULT_HEATER_DOB_THRESHOLD;
+	app_state.settings.heater_mpc_onoff = SETTINGS_DEFAULT_HEATER_MPC_ONOFF;
+	app_state.settings.heater_output_mode = SETTINGS_DEFAULT_HEATER_OUTPUT_MODE;
+	app_state.settings.heater_tprop_window = SETTINGS_DEFAULT_HEATER_TPROP_WINDOW;
+	for(uint8_t p = 0; p < TSENS_MAX_PROBES; ++p)
+	{
+		for(uint8_t b = 0; b < HEATER_GS_NUM_BANDS; ++b)
+		{
+			app_state.settings.heater_pid_gain_table[p][b] = (pid_gains_t){SETTINGS_DEFAULT_HEATER_PID_KP, SETTINGS_DEFAULT_HEATER_PID_TI, SETTINGS_DEFAULT_HEATER_PID_TD};
+		}
+	}
 	app_state.settings.controlling_tprobe = SETTINGS_DEFAULT_CONTROLLING_TPROBE;
+	app_state.settings.stirrer_waveform = SETTINGS_DEFAULT_STIRRER_WAVEFORM;
+	app_state.settings.stirrer_period = SETTINGS_DEFAULT_STIRRER_PERIOD;
+	app_state.settings.stirrer_depth = SETTINGS_DEFAULT_STIRRER_DEPTH;
 	app_state.settings.fan_duty_cycle = SETTINGS_DEFAULT_FAN_DUTY_CYCLE;
+	app_state.settings.fan_closed_loop_onoff = SETTINGS_DEFAULT_FAN_CLOSED_LOOP_ONOFF;
+	app_state.settings.fan_curve_onoff = SETTINGS_DEFAULT_FAN_CURVE_ONOFF;
+	app_state.settings.fan_idle_duty_cycle = SETTINGS_DEFAULT_FAN_IDLE_DUTY_CYCLE;
+	app_state.settings.eco_onoff = SETTINGS_DEFAULT_ECO_ONOFF;
+	app_state.settings.eco_timeout = SETTINGS_DEFAULT_ECO_TIMEOUT;
+	app_state.settings.eco_temp = SETTINGS_DEFAULT_ECO_TEMP;
+	#if HEATER_NUM_ZONES > 1
+		for(uint8_t i = 0; i < HEATER_NUM_ZONES - 1; ++i)
+		{
+			app_state.settings.zones[i].target_temp = SETTINGS_DEFAULT_ZONE_TARGET_TEMP;
+			app_state.settings.zones[i].gains = (pid_gains_t){SETTINGS_DEFAULT_HEATER_PID_KP, SETTINGS_DEFAULT_HEATER_PID_TI, SETTINGS_DEFAULT_HEATER_PID_TD};
+			app_state.settings.zones[i].controlling_tprobe = SETTINGS_DEFAULT_ZONE_TPROBE;
+		}
+	#endif
+}
+
+void app_apply_pid_settings()
+{
+	pid_gains_t gains = {app_state.settings.heater_pid_kp, app_state.settings.heater_pid_ti, app_state.settings.heater_pid_td};
+	// scheduled gains for the current set point and controlling probe
+	if(app_state.settings.heater_pid_gs_onoff)
+		pid_interpolate_gains(app_state.settings.heater_pid_gain_table[app_state.settings.controlling_tprobe], HEATER_GS_NUM_BANDS, HEATER_GS_FIRST_BAND_TEMP, HEATER_GS_BAND_TEMP_STEP, app_state.settings.heater_target_temp, &gains);
+	pid_set_params(&app_state.pid_state, gains.Kp, gains.Ti, gains.Td, app_state.settings.heater_pid_i_clamp, app_state.settings.heater_pid_offset, app_state.settings.heater_pid_d_filter_cutoff, app_state.settings.heater_pid_d_filter_q, app_state.settings.heater_pid_sp_weight_p, app_state.settings.heater_pid_sp_weight_d, app_state.settings.heater_pid_sp_filter_tc, HEATER_CONTROL_MIN, HEATER_CONTROL_MAX);
+	pid_set_velocity_form(&app_state.pid_state, app_state.settings.heater_pid_velocity_onoff);
+	float model_gain = app_get_model_gain();
+	smith_set_params(&app_state.smith_state, model_gain, app_state.settings.heater_model_tau, app_state.settings.heater_model_dead_time);
+	dob_set_params(&app_state.dob_state, model_gain, app_state.settings.heater_model_tau);
+	trs_set_params(&app_state.trs_state, model_gain, app_state.settings.heater_model_tau);
+	// zones share limits and filters with the main heater
+	#if HEATER_NUM_ZONES > 1
+		for(uint8_t i = 0; i < HEATER_NUM_ZONES - 1; ++i)
+			app_apply_zone_settings(i);
+	#endif
+}
+
+void app_apply_zone_settings(uint8_t zone_index)
+{
+	#if HEATER_NUM_ZONES > 1
+		pid_gains_t* gains = &app_state.settings.zones[zone_index].gains;
+		pid_set_params(&app_state.zones[zone_index].pid_state, gains->Kp, gains->Ti, gains->Td, app_state.settings.heater_pid_i_clamp, app_state.settings.heater_pid_offset, app_state.settings.heater_pid_d_filter_cutoff, app_state.settings.heater_pid_d_filter_q, 1.0, 0.0, 0.0, HEATER_CONTROL_MIN, HEATER_CONTROL_MAX);
+	#endif
+}
+
+uint8_t app_get_probe_temp(uint8_t tprobe, float* temp)
+{
+	switch(tprobe)
+	{
+		#ifdef TSENS_PROBE_0
+		case 0:
+			*temp = app_state.t0_current_temp;
+			return TRUE;
+			#endif
+		#ifdef TSENS_PROBE_1
+		case 1:
+			*temp = app_state.t1_current_temp;
+			return TRUE;
+			#endif
+		#ifdef TSENS_PROBE_2
+		case 2:
+			*temp = app_state.t2_current_temp;
+			return TRUE;
+			#endif
+		#ifdef TSENS_PROBE_3
+		case 3:
+			*temp = app_state.t3_current_temp;
+			return TRUE;
+			#endif
+		default:
+			*temp = 0.0;
+			return FALSE;
+	}
+}
+
+void app_apply_heater_output_settings()
+{
+	heater_set_output_mode(app_state.settings.heater_output_mode, app_state.settings.heater_tprop_window);
+}
+
+void app_apply_stirrer_settings()
+{
+	agt_set_params(&app_state.agitation_state, app_state.settings.stirrer_waveform, app_state.settings.stirrer_period, app_state.settings.stirrer_depth);
+}
+
+float app_get_model_gain()
+{
+	// plant model gain is the inverse of the learned holding duty cycle per kelvin, if something was learned already
+	return app_state.ff_state.gain > 0.0 ? fmin(1.0 / app_state.ff_state.gain, HEATER_MODEL_MAX_GAIN) : HEATER_MODEL_DEFAULT_GAIN;
 }
 
 void app_load_settings_from_eeprom()
 {
 	eeprom_settings_t load_settings;
-	eeprom_read_block(&load_settings, &app_eeprom_settings, sizeof(eeprom_settings_t));
+	eeprom_read_block(&load_settings, APP_EEPROM_SETTINGS, sizeof(eeprom_settings_t));
 	// if no valid data was found in eeprom, initialize it with default settings
 	if(load_settings.magic_number != EEPROM_SETTINGS_MAGIC_NUMBER)
 	{
@@ -1172,11 +3189,223 @@ void app_load_settings_from_eeprom()
 	{
 		app_state.settings = load_settings.settings;
 	}
-	pid_set_params(&app_state.pid_state, app_state.settings.heater_pid_kp, app_state.settings.heater_pid_ti, app_state.settings.heater_pid_td, app_state.settings.heater_pid_i_clamp, app_state.settings.heater_pid_offset, app_state.settings.heater_pid_d_smoothing_factor, HEATER_CONTROL_MIN, HEATER_CONTROL_MAX);
+	ff_set_gain(&app_state.ff_state, app_state.heater_ff_gains[app_state.settings.controlling_tprobe]);
+	app_apply_pid_settings();
 }
 
 void app_store_settings_to_eeprom()
 {
 	eeprom_settings_t store_settings = {EEPROM_SETTINGS_MAGIC_NUMBER, app_state.settings};
-	eeprom_update_block(&store_settings, &app_eeprom_settings, sizeof(eeprom_settings_t));
-}
\ No newline at end of file
+	eeprom_update_block(&store_settings, APP_EEPROM_SETTINGS, sizeof(eeprom_settings_t));
+}
+
+void app_load_learned_from_eeprom()
+{
+	eeprom_learned_t load_learned;
+	eeprom_read_block(&load_learned, APP_EEPROM_LEARNED, sizeof(eeprom_learned_t));
+	// nothing learned yet, start from defaults
+	if(load_learned.magic_number != EEPROM_LEARNED_MAGIC_NUMBER)
+	{
+		for(uint8_t i = 0; i < TSENS_MAX_PROBES; ++i)
+			app_state.heater_ff_gains[i] = HEATER_FF_DEFAULT_GAIN;
+		app_store_learned_to_eeprom();
+	}
+	else
+	{
+		for(uint8_t i = 0; i < TSENS_MAX_PROBES; ++i)
+			app_state.heater_ff_gains[i] = load_learned.heater_ff_gains[i];
+	}
+	app_state.heater_ff_gains_dirty = FALSE;
+}
+
+void app_store_learned_to_eeprom()
+{
+	eeprom_learned_t store_learned;
+	store_learned.magic_number = EEPROM_LEARNED_MAGIC_NUMBER;
+	for(uint8_t i = 0; i < TSENS_MAX_PROBES; ++i)
+		store_learned.heater_ff_gains[i] = app_state.heater_ff_gains[i];
+	eeprom_update_block(&store_learned, APP_EEPROM_LEARNED, sizeof(eeprom_learned_t));
+	app_state.heater_ff_gains_dirty = FALSE;
+	app_state.heater_ff_store_time = appt_get_cycles_since_startup();
+}
+
+void app_load_stats_from_eeprom()
+{
+	eeprom_stats_t load_stats;
+	eeprom_read_block(&load_stats, APP_EEPROM_STATS, sizeof(eeprom_stats_t));
+	// nothing counted yet
+	if(load_stats.magic_number != EEPROM_STATS_MAGIC_NUMBER)
+	{
+		load_stats.lifetime = (egy_counter_t){0, 0};
+		egy_init(&app_state.energy_state, &load_stats.lifetime);
+		app_store_stats_to_eeprom();
+	}
+	else
+	{
+		egy_init(&app_state.energy_state, &load_stats.lifetime);
+		app_state.energy_store_time = appt_get_cycles_since_startup();
+	}
+}
+
+void app_store_stats_to_eeprom()
+{
+	eeprom_stats_t store_stats;
+	store_stats.magic_number = EEPROM_STATS_MAGIC_NUMBER;
+	store_stats.lifetime = app_state.energy_state.lifetime;
+	eeprom_update_block(&store_stats, APP_EEPROM_STATS, sizeof(eeprom_stats_t));
+	app_state.energy_state.lifetime_dirty = FALSE;
+	app_state.energy_store_time = appt_get_cycles_since_startup();
+}
+
+void app_load_recipe_from_eeprom()
+{
+	eeprom_recipe_t load_recipe;
+	eeprom_read_block(&load_recipe, APP_EEPROM_RECIPE, sizeof(eeprom_recipe_t));
+	// no recipe stored yet, start with an empty one
+	if(load_recipe.magic_number != EEPROM_RECIPE_MAGIC_NUMBER)
+	{
+		for(uint8_t i = 0; i < RCP_MAX_SEGMENTS; ++i)
+			app_state.recipe[i] = (rcp_segment_t){RCP_SEG_END, 0, 0};
+		app_store_recipe_to_eeprom();
+	}
+	else
+	{
+		for(uint8_t i = 0; i < RCP_MAX_SEGMENTS; ++i)
+			app_state.recipe[i] = load_recipe.segments[i];
+	}
+}
+
+void app_store_recipe_to_eeprom()
+{
+	eeprom_recipe_t store_recipe;
+	store_recipe.magic_number = EEPROM_RECIPE_MAGIC_NUMBER;
+	for(uint8_t i = 0; i < RCP_MAX_SEGMENTS; ++i)
+		store_recipe.segments[i] = app_state.recipe[i];
+	// only changed bytes are written
+	eeprom_update_block(&store_recipe, APP_EEPROM_RECIPE, sizeof(eeprom_recipe_t));
+}
+
+void app_set_heater_onoff(uint8_t onoff)
+{
+	if(onoff && !app_state.heater_onoff) // new session
+	{
+		egy_reset_session(&app_state.energy_state);
+		eta_reset(&app_state.eta_state, app_state.process_value);
+	}
+	app_state.heater_onoff = onoff;
+	if(onoff)
+	{
+		// held off in degraded mode, switched on when the fault clears
+		if(!app_state.degraded_error)
+			heater_on();
+	}
+	else
+	{
+		heater_off();
+		// end of session, keep the lifetime counters
+		if(app_state.energy_state.lifetime_dirty)
+			app_store_stats_to_eeprom();
+		app_state.heater_rapid_heating = FALSE;
+		// switching the heater off manually aborts a running recipe
+		rcp_stop(&app_state.recipe_state);
+	}
+}
+
+void app_set_stirrer_duty_cycle(uint8_t duty_cycle)
+{
+	app_state.stirrer_duty_cycle = duty_cycle;
+	// the agitation generator ramps the stirrer to the new duty cycle and switches it on / off
+	agt_set_duty_cycle(&app_state.agitation_state, duty_cycle);
+}
+
+void app_set_fan_duty_cycle(uint8_t duty_cycle)
+{
+	app_state.fan_duty_cycle = duty_cycle;
+	if(!app_state.fan_onoff && app_state.fan_duty_cycle > 0) // fan was switched on
+	{
+		fan_on();
+		fctl_reset(&app_state.fan_control_state);
+	}
+	else if(app_state.fan_onoff && (app_state.fan_duty_cycle == 0)) // fan was switched off
+	{
+		fan_off();
+	}
+	
+	app_state.fan_onoff = app_state.fan_duty_cycle > 0;
+	
+	// set fan duty cycle, the speed controller takes care of it in closed loop mode
+	if(!app_state.settings.fan_closed_loop_onoff)
+		fan_set_duty_cycle(app_state.fan_duty_cycle);
+}
+
+void app_set_zone_onoff(uint8_t zone_index, uint8_t onoff)
+{
+	#if HEATER_NUM_ZONES > 1
+		// zones stay off in degraded mode
+		if(onoff && app_state.degraded_error)
+			return;
+		app_state.zones[zone_index].onoff = onoff;
+		if(onoff)
+		{
+			heater_zone_set_duty_cycle(zone_index + 1, 0);
+			heater_zone_on(zone_index + 1);
+		}
+		else
+		{
+			heater_zone_off(zone_index + 1);
+			app_state.zones[zone_index].rapid_heating = FALSE;
+		}
+	#endif
+}
+
+void app_set_target_temp(float temp)
+{
+	temp = fmax(fmin(temp, MAX_HEATER_TARGET_TEMP), MIN_HEATER_TARGET_TEMP);
+	if(temp == app_state.settings.heater_target_temp)
+		return;
+	app_state.settings.heater_target_temp = temp;
+	// scheduled gains depend on the set point
+	app_apply_pid_settings();
+}
+
+void app_set_eco_standby(uint8_t onoff)
+{
+	if(onoff == app_state.eco_active)
+		return;
+	app_state.eco_active = onoff;
+	if(onoff)
+	{
+		// the user set point is kept and restored on wake up
+		app_state.eco_saved_target_temp = app_state.settings.heater_target_temp;
+		app_state.eco_saved_stirrer_duty_cycle = app_state.stirrer_duty_cycle;
+		if(app_state.settings.eco_temp < app_state.settings.heater_target_temp)
+			app_set_target_temp(app_state.settings.eco_temp);
+		app_set_stirrer_duty_cycle(0);
+	}
+	else
+	{
+		app_set_target_temp(app_state.eco_saved_target_temp);
+		app_set_stirrer_duty_cycle(app_state.eco_saved_stirrer_duty_cycle);
+		eta_reset(&app_state.eta_state, app_state.process_value);
+		// main screen shows the time until the bath is back at the target temp
+		app_state.selected_menu_item_index = 0;
+		app_state.current_state_func = app_state_main;
+	}
+}
+
+float app_get_time_to_ready()
+{
+	float target = app_state.settings.heater_target_temp;
+	if(app_state.process_value >= target - HEATER_READY_BAND)
+		return 0.0;
+	// fit of the observed heat up curve
+	float eta = eta_estimate(&app_state.eta_state, app_state.process_value, target);
+	if(eta != ETA_UNKNOWN || app_state.eta_state.samples >= ETA_MIN_SAMPLES)
+		return eta;
+	// nothing observed yet: first order plant model at full power: the bath approaches ambient + gain * 100% with the model time constant
+	float final_temp = app_state.ff_state.ambient_temp + app_get_model_gain() * HEATER_CONTROL_MAX;
+	if(final_temp <= target)
+		return -1.0; // not reachable according to the model
+	return app_state.settings.heater_model_tau * log((final_temp - app_state.process_value) / (final_temp - target));
+}
+
@@ -42,6 +42,18 @@ SOFTWARE.
 #include "stirrer_fan.h"
 #include "heater.h"
 #include "PID.h"
+#include "feedforward.h"
+#include "smith_predictor.h"
+#include "dist_observer.h"
+#include "tr_supervisor.h"
+#include "dry_detect.h"
+#include "mpc.h"
+#include "recipe.h"
+#include "agitation.h"
+#include "fan_control.h"
+#include "fan_curve.h"
+#include "energy.h"
+#include "eta.h"
 
 // menu stuff
 #include "menu_rendering.h"
@@ -50,6 +62,14 @@ SOFTWARE.
 #include "my_util.h"
 
 //////////////////////////////////// DATA STRUCTURES / DEFINITIONS /////////////////////////////////
+// settings of the additional heater zones. The zones share limits and filters of the main heater pid.
+typedef struct
+{
+	float target_temp;
+	pid_gains_t gains;
+	uint8_t controlling_tprobe;
+} app_zone_settings_t;
+
 typedef struct
 {
 	float heater_target_temp;
@@ -58,9 +78,36 @@ typedef struct
 	float heater_pid_td;
 	float heater_pid_i_clamp;
 	float heater_pid_offset;
-	float heater_pid_d_smoothing_factor;
+	float heater_pid_d_filter_cutoff;
+	float heater_pid_d_filter_q;
+	float heater_pid_sp_weight_p;
+	float heater_pid_sp_weight_d;
+	float heater_pid_sp_filter_tc;
+	uint8_t heater_pid_velocity_onoff;
+	uint8_t heater_pid_gs_onoff;
+	pid_gains_t heater_pid_gain_table[TSENS_MAX_PROBES][HEATER_GS_NUM_BANDS];
+	uint8_t heater_smith_onoff;
+	float heater_model_tau;
+	float heater_model_dead_time;
+	uint8_t heater_dob_onoff;
+	float heater_dob_threshold;
+	uint8_t heater_mpc_onoff;
+	uint8_t heater_output_mode;
+	float heater_tprop_window;
 	uint8_t controlling_tprobe;
+	uint8_t stirrer_waveform;
+	float stirrer_period;
+	uint8_t stirrer_depth;
 	uint8_t fan_duty_cycle;
+	uint8_t fan_closed_loop_onoff;
+	uint8_t fan_curve_onoff;
+	uint8_t fan_idle_duty_cycle;
+	uint8_t eco_onoff;
+	uint16_t eco_timeout;		// minutes
+	float eco_temp;
+	#if HEATER_NUM_ZONES > 1
+	app_zone_settings_t zones[HEATER_NUM_ZONES - 1];	// heater zones 1 .. HEATER_NUM_ZONES - 1
+	#endif
 } app_settings_t;
 
 typedef struct
@@ -79,7 +126,41 @@ typedef struct
 	uint8_t magic_number;
 	app_settings_t settings;
 } eeprom_settings_t;
-#define EEPROM_SETTINGS_MAGIC_NUMBER 42
+#define EEPROM_SETTINGS_MAGIC_NUMBER 56
+
+// learned values are stored separately, so they survive a reset of the user settings and are written at a lower rate
+typedef struct
+{
+	uint8_t magic_number;
+	float heater_ff_gains[TSENS_MAX_PROBES];	// learned heat loss feedforward gain per controlling probe
+} eeprom_learned_t;
+#define EEPROM_LEARNED_MAGIC_NUMBER 42
+
+typedef struct
+{
+	uint8_t magic_number;
+	rcp_segment_t segments[RCP_MAX_SEGMENTS];
+} eeprom_recipe_t;
+#define EEPROM_RECIPE_MAGIC_NUMBER 42
+
+typedef struct
+{
+	uint8_t magic_number;
+	egy_counter_t lifetime;
+} eeprom_stats_t;
+#define EEPROM_STATS_MAGIC_NUMBER 42
+
+// fixed eeprom layout. Every block has a reserved slot, so a firmware update that changes the settings layout doesn't move
+// the learned values, the recipe and the lifetime counters onto stale bytes.
+#define APP_EEPROM_SETTINGS_SLOT 0x000
+#define APP_EEPROM_LEARNED_SLOT 0x200
+#define APP_EEPROM_STATS_SLOT 0x240
+#define APP_EEPROM_RECIPE_SLOT 0x280
+#define APP_EEPROM_END 0x380
+#define APP_EEPROM_SETTINGS ((eeprom_settings_t*)APP_EEPROM_SETTINGS_SLOT)
+#define APP_EEPROM_LEARNED ((eeprom_learned_t*)APP_EEPROM_LEARNED_SLOT)
+#define APP_EEPROM_STATS ((eeprom_stats_t*)APP_EEPROM_STATS_SLOT)
+#define APP_EEPROM_RECIPE ((eeprom_recipe_t*)APP_EEPROM_RECIPE_SLOT)
 
 // define safety temp varname
 #ifdef HEATER_SAFETY_TPROBE
@@ -98,7 +179,83 @@ typedef struct
 #error "No safety tprobe index defined."
 #endif
 
+// define enclosure temp varname
+#ifdef FAN_CURVE_TPROBE
+#if FAN_CURVE_TPROBE == 0 && TSENS_PROBE_0_PRESENT
+#define FAN_CURVE_TPROBE_CURRENT_TEMP app_state.t0_current_temp
+#elif FAN_CURVE_TPROBE == 1 && TSENS_PROBE_1_PRESENT
+#define FAN_CURVE_TPROBE_CURRENT_TEMP app_state.t1_current_temp
+#elif FAN_CURVE_TPROBE == 2 && TSENS_PROBE_2_PRESENT
+#define FAN_CURVE_TPROBE_CURRENT_TEMP app_state.t2_current_temp
+#elif FAN_CURVE_TPROBE == 3 && TSENS_PROBE_3_PRESENT
+#define FAN_CURVE_TPROBE_CURRENT_TEMP app_state.t3_current_temp
+#else
+#error "Unknown fan curve tprobe index."
+#endif
+#endif
+
+// zones menu only with more than one heater zone
+#if HEATER_NUM_ZONES > 1
+#define APP_MAIN_MENU_LAST_ITEM 9
+#else
+#define APP_MAIN_MENU_LAST_ITEM 8
+#endif
+
+// energy pages, fault count and fault history
+#define APP_STATS_LAST_PAGE (6 + APP_FAULT_HISTORY_SIZE)
+
+// error policies
+#define APP_EP_RECOVER 0	// heater held off, clears after enough fault free control steps
+#define APP_EP_LATCH 1		// heater held off until the fault is acknowledged on the main screen
+#define APP_EP_HALT 2		// emergency shutdown
+#define APP_EP_LOG 3		// recorded in the fault history, control continues (auxiliary probes)
+
+#define APP_NO_PROBE 0xFF
+
+// self-test steps and results
+#define APP_SELF_TEST_STEP_START 0
+#define APP_SELF_TEST_STEP_PULSE 1
+#define APP_SELF_TEST_STEP_RESULT 2
+
+#define APP_SELF_TEST_PASS 0
+#define APP_SELF_TEST_FAIL_ADC 1
+#define APP_SELF_TEST_FAIL_HEATER 2
+#define APP_SELF_TEST_FAIL_FAN 3
+
+#define APP_SELF_TEST_HEATER_OK 0x01
+#define APP_SELF_TEST_FAN_OK 0x02
+
+// closed loop fan menu items need the tachometer
+#ifdef FAN_TACH
+#define APP_FAN_MENU_LAST_ITEM 5
+#else
+#define APP_FAN_MENU_LAST_ITEM 3
+#endif
+
 //////////////////////////////////// APP STATE /////////////////////////////////////////////////////
+// runtime state of an additional heater zone
+typedef struct
+{
+	pid_state_t pid_state;
+	uint8_t onoff;
+	uint8_t duty_cycle;					// duty cycle of the last control step
+	uint8_t rapid_heating;
+	float tr_check_start_temp;			// thermal runaway check start temperature
+	appt_cycle_t tr_check_start_time;	// thermal runaway check start time
+} app_zone_state_t;
+
+typedef struct
+{
+	uint8_t action;
+	uint8_t recover_ticks;		// fault free control steps until a recoverable fault clears
+} app_error_policy_t;
+
+typedef struct
+{
+	ErrorCode error;
+	uint8_t probe;				// APP_NO_PROBE if the fault is not tied to a probe
+	uint32_t time;				// seconds since startup
+} app_fault_t;
 
 
 typedef struct {
@@ -114,21 +271,76 @@ typedef struct {
 	// state machine
 	state_function current_state_func;
 	int8_t selected_menu_item_index;
+	uint8_t menu_edit_index;		// entry edited by value states which serve more than one entry
 	ErrorCode current_error;
 	
+	// degraded mode
+	ErrorCode degraded_error;		// active fault while the heater is held off, EC_SUCCESS in normal operation
+	uint8_t degraded_probe;
+	uint8_t degraded_latched;
+	uint8_t degraded_good_ticks;	// fault free control steps since the last fault
+	uint8_t degraded_zones;			// zones switched off by the fault, bit per zone
+	ErrorCode probe_errors[TSENS_MAX_PROBES];	// logged faults of auxiliary probes, EC_SUCCESS while fine
+	uint8_t error_probe;			// probe measured by the control loop, APP_NO_PROBE outside the probe checks
+	app_fault_t fault_history[APP_FAULT_HISTORY_SIZE];	// ring buffer of the last faults
+	uint8_t fault_history_next;
+	uint16_t fault_count;			// faults since startup
+	
+	// self-test
+	uint8_t self_test_step;
+	uint8_t self_test_result;
+	uint8_t self_test_probe;		// failed probe of the adc check, APP_NO_PROBE otherwise
+	uint8_t self_test_passed;		// APP_SELF_TEST_*_OK of the running pulse step
+	float self_test_start_temp;
+	uint16_t self_test_start_pulses;	// fan tach pulses at the start of the pulse step
+	appt_cycle_t self_test_start_time;
+	
 	// controller state
 	pid_state_t pid_state;	
+	uint8_t heater_pid_tprobe;		// controlling probe of the last pid step
+	uint8_t heater_pid_smith;		// smith predictor setting of the last pid step
+	ff_state_t ff_state;
+	smith_state_t smith_state;
+	dob_state_t dob_state;
+	trs_state_t trs_state;
+	dry_state_t dry_state;
+	float heater_ff_gains[TSENS_MAX_PROBES];	// learned feedforward gains, persisted in eeprom
+	uint8_t heater_ff_gains_dirty;				// learned gains changed since last eeprom write
+	appt_cycle_t heater_ff_store_time;			// time of the last eeprom write of the learned gains
+	float process_value;					// last temperature of the controlling probe
+	rcp_state_t recipe_state;
+	rcp_segment_t recipe[RCP_MAX_SEGMENTS];	// persisted in eeprom
+	agt_state_t agitation_state;
+	fctl_state_t fan_control_state;
+	fcurve_state_t fan_curve_state;
+	egy_state_t energy_state;
+	eta_state_t eta_state;
+	appt_cycle_t energy_store_time;			// time of the last eeprom write of the lifetime counters
 	uint8_t stirrer_duty_cycle;
 	uint8_t fan_duty_cycle;
+	uint8_t heater_duty_cycle;		// duty cycle of the last control step
+	#ifdef HEATER_VSENSE
+	float supply_voltage;			// filtered heater supply voltage
+	#endif
 	uint8_t heater_rapid_heating;
 	uint8_t heater_onoff;
 	uint8_t stirrer_onoff;
 	uint8_t fan_onoff;
 	
+	// eco standby
+	appt_cycle_t eco_last_input_time;
+	uint8_t eco_active;				// set point lowered and stirrer stopped after the idle timeout
+	float eco_saved_target_temp;
+	uint8_t eco_saved_stirrer_duty_cycle;
+	#if HEATER_NUM_ZONES > 1
+	app_zone_state_t zones[HEATER_NUM_ZONES - 1];
+	#endif
+	
 	// sensor state
 	#ifdef TSENS_PROBE_0
 	float t0_current_temp;					// value of last t0 temp measurement
 	float t0_resistance;					// value of last t0 resistance meaturement
+	tsens_plausibility_t t0_plausibility;	// rate of change plausibility filter
 	float t0_tr_check_start_temp;			// thermal runaway check start temperature
 	appt_cycle_t t0_tr_check_start_time;	// thermal runaway check start time
 	#endif
@@ -136,6 +348,7 @@ typedef struct {
 	#ifdef TSENS_PROBE_1
 	float t1_current_temp;					// value of last t1 temp measurement
 	float t1_resistance;					// value of last t1 resistance meaturement
+	tsens_plausibility_t t1_plausibility;	// rate of change plausibility filter
 	float t1_tr_check_start_temp;			// thermal runaway check start temperature
 	appt_cycle_t t1_tr_check_start_time;	// thermal runaway check start time
 	#endif
@@ -143,6 +356,7 @@ typedef struct {
 	#ifdef TSENS_PROBE_2
 	float t2_current_temp;					// value of last t2 temp measurement
 	float t2_resistance;					// value of last t2 resistance meaturement
+	tsens_plausibility_t t2_plausibility;	// rate of change plausibility filter
 	float t2_tr_check_start_temp;			// thermal runaway check start temperature
 	appt_cycle_t t2_tr_check_start_time;	// thermal runaway check start time
 	#endif
@@ -150,6 +364,7 @@ typedef struct {
 	#ifdef TSENS_PROBE_3
 	float t3_current_temp;					// value of last t3 temp measurement
 	float t3_resistance;					// value of last t3 resistance meaturement
+	tsens_plausibility_t t3_plausibility;	// rate of change plausibility filter
 	float t3_tr_check_start_temp;			// thermal runaway check start temperature
 	appt_cycle_t t3_tr_check_start_time;	// thermal runaway check start time
 	#endif
@@ -162,8 +377,28 @@ ErrorCode app_user_main();
 ErrorCode app_control();
 ErrorCode app_rotenc_update();
 ErrorCode app_button_update();
+ErrorCode app_recipe_update();
+ErrorCode app_agitation_update();
+ErrorCode app_fan_update();
+ErrorCode app_heater_output_update();
+#ifdef TSENS_PROBE_0
+ErrorCode app_update_probe0();
+#endif
+#ifdef TSENS_PROBE_1
+ErrorCode app_update_probe1();
+#endif
+#ifdef TSENS_PROBE_2
+ErrorCode app_update_probe2();
+#endif
+#ifdef TSENS_PROBE_3
+ErrorCode app_update_probe3();
+#endif
+#if HEATER_NUM_ZONES > 1
+ErrorCode app_zone_control(uint8_t zone_index);
+#endif
 
 // state functions
+ErrorCode app_state_self_test();
 ErrorCode app_state_main();
 ErrorCode app_state_menu_main();
 	ErrorCode app_state_menu_heater();
@@ -176,11 +411,59 @@ ErrorCode app_state_menu_main();
 			ErrorCode app_state_menu_heater_pid_d();
 			ErrorCode app_state_menu_heater_pid_i_clamp();
 			ErrorCode app_state_menu_heater_pid_offset();
-			ErrorCode app_state_menu_heater_pid_d_smoothing_factor();
+			ErrorCode app_state_menu_heater_pid_d_filter();
+				ErrorCode app_state_menu_heater_pid_d_filter_cutoff();
+				ErrorCode app_state_menu_heater_pid_d_filter_q();
+			ErrorCode app_state_menu_heater_pid_sp_weight_p();
+			ErrorCode app_state_menu_heater_pid_sp_weight_d();
+			ErrorCode app_state_menu_heater_pid_sp_filter_tc();
+			ErrorCode app_state_menu_heater_pid_gs();
+				ErrorCode app_state_menu_heater_pid_gs_onoff();
+				ErrorCode app_state_menu_heater_pid_gs_entry();
+			ErrorCode app_state_menu_heater_pid_smith();
+				ErrorCode app_state_menu_heater_pid_smith_onoff();
+				ErrorCode app_state_menu_heater_pid_smith_tau();
+				ErrorCode app_state_menu_heater_pid_smith_dead_time();
+			ErrorCode app_state_menu_heater_pid_dob();
+				ErrorCode app_state_menu_heater_pid_dob_onoff();
+				ErrorCode app_state_menu_heater_pid_dob_threshold();
+			ErrorCode app_state_menu_heater_pid_velocity_onoff();
+			ErrorCode app_state_menu_heater_pid_mpc_onoff();
+		ErrorCode app_state_menu_heater_output();
+			ErrorCode app_state_menu_heater_output_mode();
+			ErrorCode app_state_menu_heater_output_window();
+		ErrorCode app_state_menu_heater_eco();
+			ErrorCode app_state_menu_heater_eco_onoff();
+			ErrorCode app_state_menu_heater_eco_timeout();
+			ErrorCode app_state_menu_heater_eco_temp();
 	ErrorCode app_state_menu_stirrer();
 		ErrorCode app_state_menu_stirrer_duty_cycle();
+		ErrorCode app_state_menu_stirrer_waveform();
+		ErrorCode app_state_menu_stirrer_period();
+		ErrorCode app_state_menu_stirrer_depth();
 	ErrorCode app_state_menu_fan();
 		ErrorCode app_state_menu_fan_duty_cycle();
+		ErrorCode app_state_menu_fan_curve_onoff();
+		ErrorCode app_state_menu_fan_idle_duty_cycle();
+		ErrorCode app_state_menu_fan_closed_loop_onoff();
+		ErrorCode app_state_menu_fan_rpm();
+	ErrorCode app_state_menu_recipe();
+		ErrorCode app_state_menu_recipe_run();
+		ErrorCode app_state_menu_recipe_segment();
+			ErrorCode app_state_menu_recipe_segment_type();
+			ErrorCode app_state_menu_recipe_segment_value();
+			ErrorCode app_state_menu_recipe_segment_arg();
+	ErrorCode app_state_menu_stats();
+	#if HEATER_NUM_ZONES > 1
+	ErrorCode app_state_menu_zone();
+		ErrorCode app_state_menu_zone_edit();
+			ErrorCode app_state_menu_zone_onoff();
+			ErrorCode app_state_menu_zone_target_temp();
+			ErrorCode app_state_menu_zone_controlling_tprobe();
+			ErrorCode app_state_menu_zone_pid_p();
+			ErrorCode app_state_menu_zone_pid_i();
+			ErrorCode app_state_menu_zone_pid_d();
+	#endif
 	ErrorCode app_state_menu_tprobe();
 		ErrorCode app_state_menu_tprobe0_calib();
 		ErrorCode app_state_menu_tprobe1_calib();
@@ -192,10 +475,41 @@ ErrorCode app_state_menu_main();
 // error display
 void app_error_display();			
 
+// error handling
+void app_handle_error(ErrorCode ec);
+const app_error_policy_t* app_get_error_policy(ErrorCode ec, uint8_t probe);
+uint8_t app_get_fault_probe(ErrorCode ec);
+uint8_t app_check_probe_fault(ErrorCode ec);
+void app_record_fault(ErrorCode ec, uint8_t probe);
+void app_clear_degraded();
+void app_acknowledge_fault();
+const app_fault_t* app_get_fault(uint8_t age_index);
+void app_stop_self_test_outputs();
+void app_finish_self_test(uint8_t result, uint8_t probe);
+
 // helpers
 void app_clear_input();
 void app_load_default_settings();
+void app_apply_pid_settings();
+void app_apply_stirrer_settings();
+void app_apply_heater_output_settings();
+void app_apply_zone_settings(uint8_t zone_index);
+uint8_t app_get_probe_temp(uint8_t tprobe, float* temp);
+float app_get_model_gain();
 void app_load_settings_from_eeprom();
 void app_store_settings_to_eeprom();
+void app_load_learned_from_eeprom();
+void app_store_learned_to_eeprom();
+void app_load_stats_from_eeprom();
+void app_store_stats_to_eeprom();
+void app_load_recipe_from_eeprom();
+void app_store_recipe_to_eeprom();
+void app_set_heater_onoff(uint8_t onoff);
+void app_set_stirrer_duty_cycle(uint8_t duty_cycle);
+void app_set_fan_duty_cycle(uint8_t duty_cycle);
+void app_set_target_temp(float temp);
+void app_set_eco_standby(uint8_t onoff);
+float app_get_time_to_ready();
+void app_set_zone_onoff(uint8_t zone_index, uint8_t onoff);
 
 #endif /* APPLICATION_H_ */
\ No newline at end of file
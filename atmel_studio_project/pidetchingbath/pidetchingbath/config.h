@@ -58,8 +58,34 @@ SOFTWARE.
 #define MIN_HEATER_PID_I_CLAMP 0.0
 #define MIN_HEATER_OFFSET -50.0
 #define MAX_HEATER_OFFSET 50.0
-#define MIN_HEATER_PID_D_SMOOTHING_FACTOR 0.0
-#define MAX_HEATER_PID_D_SMOOTHING_FACTOR 1.0
+#define MIN_HEATER_PID_D_FILTER_CUTOFF 0.01
+#define MAX_HEATER_PID_D_FILTER_CUTOFF 10.0 // below the nyquist frequency of the control loop
+#define MIN_HEATER_PID_D_FILTER_Q 0.5
+#define MAX_HEATER_PID_D_FILTER_Q 2.0
+#define MIN_HEATER_PID_SP_WEIGHT 0.0
+#define MAX_HEATER_PID_SP_WEIGHT 1.0
+#define MIN_HEATER_PID_SP_FILTER_TC 0.0
+#define MAX_HEATER_PID_SP_FILTER_TC 999.9
+
+// PID gain scheduling. One Kp/Ti/Td entry per set point band and controlling probe, interpolated linearly between the bands.
+#define HEATER_GS_NUM_BANDS 3
+#define HEATER_GS_FIRST_BAND_TEMP 25.0 // set point of the first band
+#define HEATER_GS_BAND_TEMP_STEP 15.0 // set point distance between two bands (25, 40, 55 degrees)
+
+#define MIN_HEATER_MODEL_TAU 1.0
+#define MAX_HEATER_MODEL_TAU 3600.0
+#define MIN_HEATER_MODEL_DEAD_TIME 0.0
+#define MAX_HEATER_MODEL_DEAD_TIME (HEATER_SMITH_DELAY_SLOTS * HEATER_SMITH_SLOT_TIME)
+#define MIN_HEATER_DOB_THRESHOLD 0.0
+#define MAX_HEATER_DOB_THRESHOLD 50.0
+#define MIN_HEATER_TPROP_WINDOW 1.0
+#define MAX_HEATER_TPROP_WINDOW 10.0
+#define MIN_STIRRER_PERIOD 1.0
+#define MAX_STIRRER_PERIOD 60.0
+#define MIN_STIRRER_DEPTH 0
+#define MAX_STIRRER_DEPTH 100
+#define MIN_ECO_TIMEOUT 5 // minutes
+#define MAX_ECO_TIMEOUT 480
 
 // --------------------- temp sensor -----------------------------------------
 #define TSENS_ADC_PRESCALER 64 // 2, 4, 8, 16, 32, 64, 128. F_CPU / PRESCALER should lie between 50kHz and 200kHz
@@ -71,6 +97,7 @@ SOFTWARE.
 #define TSENS_PROBE_0_A0 -0.0011518398410375126
 #define TSENS_PROBE_0_A1 0.00046229828474071683
 #define TSENS_PROBE_0_A2 -5.209446350514327e-07
+#define TSENS_PROBE_0_HEAT_CAPACITY 50.0 // J/K of the measured body (heater mat), bounds the physically possible dT/dt
 
 #define TSENS_PROBE_1
 #define TSENS_PROBE_1_RESISTANCE 10000
@@ -79,10 +106,36 @@ SOFTWARE.
 #define TSENS_PROBE_1_A0 0.0013191887792613783
 #define TSENS_PROBE_1_A1 0.00020290126749676136
 #define TSENS_PROBE_1_A2 2.351818173839399e-07
+#define TSENS_PROBE_1_HEAT_CAPACITY HEATER_BATH_HEAT_CAPACITY // J/K of the measured body (bath)
+
+// spare probes, e.g. a zone heater mat or the enclosure
+//#define TSENS_PROBE_2
+#define TSENS_PROBE_2_RESISTANCE 100000
+#define TSENS_PROBE_2_CHANNEL 2
+// steinhart-hart coefficients
+#define TSENS_PROBE_2_A0 -0.0011518398410375126
+#define TSENS_PROBE_2_A1 0.00046229828474071683
+#define TSENS_PROBE_2_A2 -5.209446350514327e-07
+#define TSENS_PROBE_2_HEAT_CAPACITY 50.0 // J/K of the measured body (zone heater mat)
+
+//#define TSENS_PROBE_3
+#define TSENS_PROBE_3_RESISTANCE 100000
+#define TSENS_PROBE_3_CHANNEL 3
+// steinhart-hart coefficients
+#define TSENS_PROBE_3_A0 -0.0011518398410375126
+#define TSENS_PROBE_3_A1 0.00046229828474071683
+#define TSENS_PROBE_3_A2 -5.209446350514327e-07
+#define TSENS_PROBE_3_HEAT_CAPACITY 50.0 // J/K of the measured body
 
 // box filter with 4-sample-width
 #define TSENS_NUM_MEASUREMENTS 4
 
+// rate of change plausibility. A sample further from the last accepted one than the heater can move the measured body
+// (times the margin, plus the noise band) is rejected and the last value is held. Intermittent connectors produce such jumps.
+#define TSENS_PLAUSIBILITY_RATE_MARGIN 5.0 // margin on the max dT/dt from heater power and heat capacity (heat sinks, model error)
+#define TSENS_PLAUSIBILITY_NOISE 0.5 // allowed jump in K on top of the physical rate
+#define TSENS_PLAUSIBILITY_MAX_FAULTS 10 // consecutive rejected samples until EC_THERMISTOR_IMPLAUSIBLE
+
 // -------------------- heater --------------------------------------------------------------------------
 // 256 gives ~60hz PWM frequency
 #define HEATER_PWM_PRESCALE 1024 // must be one out of {1, 8, 32, 64, 128, 256, 1024}
@@ -90,6 +143,38 @@ SOFTWARE.
 #define HEATER_CONTROL_MAX 100 // minimum duty cycle
 
 #define HEATER_MAX_OPERATING_TEMP 140.0 // max 100% duty cycle operating temp of heater mat
+#define HEATER_NOMINAL_POWER 60.0 // heater power in watts at 100% duty cycle (and nominal supply voltage), used for energy accounting
+#define HEATER_BATH_HEAT_CAPACITY 2000.0 // J/K of the bath (~0.5l), the default plant model time constant derives from it
+#define HEATER_STATS_STORE_INTERVAL (30 * 60) // min time in seconds between two eeprom writes of the lifetime energy counters
+#define HEATER_READY_BAND 0.5 // bath counts as ready within this distance below the target temp
+
+// heater zones. Zone 0 is the OC2A heater with the full control stack, further zones are plain pid channels
+// with their own probe and set point. Zone 1 is OC2B (same pwm as zone 0), zones 2 and 3 are software pwm pins.
+// Each additional zone needs its own heater mat probe (e.g. TSENS_PROBE_2).
+#define HEATER_NUM_ZONES 1 // 1 .. 4
+//#define HEATER_ZONE2_PORT PORTC
+//#define HEATER_ZONE2_DDR DDRC
+//#define HEATER_ZONE2_BIT PORTC1
+//#define HEATER_ZONE3_PORT PORTC
+//#define HEATER_ZONE3_DDR DDRC
+//#define HEATER_ZONE3_BIT PORTC6
+#define HEATER_SOFT_PWM_PERIOD 1.0 // software pwm period in seconds
+#define HEATER_ZONE_TR_PROTECTION_EXPECTED_TEMP_CHANGE 1.0 // at full duty cycle, the zone probe should read at least this temp change ..
+#define HEATER_ZONE_TR_PROTECTION_INTERVAL (5 * 60) // .. within this interval in seconds
+
+// heater supply voltage sense on a spare adc channel through a divider. The heater output is scaled by (V_nom / V)^2,
+// so the controller output is a fraction of the nominal heater power regardless of supply sag. Only define HEATER_VSENSE with the divider fitted.
+//#define HEATER_VSENSE
+#define HEATER_VSENSE_CHANNEL 4 // 4 .. 7
+#define HEATER_VSENSE_DIVIDER 11.0 // (R_top + R_bottom) / R_bottom
+#define HEATER_VSENSE_NOMINAL_VOLTAGE 12.0 // supply voltage the heater power is specified for
+#define HEATER_VSENSE_MAX_GAIN 2.0 // compensation limit, reached at V_nom / sqrt(2)
+#define HEATER_VSENSE_MIN_VOLTAGE 6.0 // readings outside of this band (missing or shorted divider) ..
+#define HEATER_VSENSE_MAX_VOLTAGE 16.0 // .. disable the compensation
+#define HEATER_VSENSE_FILTER_TC 0.2 // low pass time constant of the voltage reading in seconds
+
+// time proportioning output for mains heaters on relays / SSRs (see HEATER_OUTPUT_* in heater.h)
+#define HEATER_TPROP_MIN_SWITCH_TIME 0.5 // min on and off time in seconds
 	
 // heater thermal protection stuff
 #define HEATER_SAFETY_TPROBE 0 // heater-attached safety probe index {0, 1, 2, 3}. Selected probe must be present and configured. Used to limit temperature of the heating element itself.
@@ -100,23 +185,115 @@ SOFTWARE.
 // if the temperature change after that time interval is smaller than the expected change, THERMAL_RUNAWAY_ERROR is triggered.
 #define HEATER_PROBE0_TR_PROTECTION_EXPECTED_TEMP_CHANGE 1.0 // expected temp change for probe 0
 #define HEATER_PROBE1_TR_PROTECTION_EXPECTED_TEMP_CHANGE 1.0 // expected temp change for probe 1
-//#define HEATER_PROBE2_EXPECTED_TEMP_CHANGE 1.0 //
-//#define HEATER_PROBE3_EXPECTED_TEMP_CHANGE 1.0 //
+#define HEATER_PROBE2_TR_PROTECTION_EXPECTED_TEMP_CHANGE 1.0 // expected temp change for probe 2
+#define HEATER_PROBE3_TR_PROTECTION_EXPECTED_TEMP_CHANGE 1.0 // expected temp change for probe 3
 
 // time intervals for thermal runway protection (time in seconds)
 #define HEATER_PROBE0_TR_PROTECTION_INTERVAL 60 // at full heater dc, the heater mat thermistor should read at least 1 degrees temp change within 60 seconds
 #define HEATER_PROBE1_TR_PROTECTION_INTERVAL (5 * 60) // at full heater dc, the bath thermistor should read at least 1 degrees temp change within 5 minutes
-//#define HEATER_PROBE2_TR_PROTECTION_INTERVAL 20
-//#define HEATER_PROBE3_TR_PROTECTION_INTERVAL 20
+#define HEATER_PROBE2_TR_PROTECTION_INTERVAL 60
+#define HEATER_PROBE3_TR_PROTECTION_INTERVAL 60
 
 // defines the min duty cycle of the heater at which the TRP starts counting (has to be less than or equal to HEATER_CONTROL_MAX)
 #define HEATER_TR_DUTY_CYCLE HEATER_CONTROL_MAX - 1
 
+// model based thermal runaway supervisor, active at any duty cycle. Compares the measured temperature rise of the controlling probe
+// with the rise the plant model expects for the applied duty cycle.
+#define HEATER_TRS_INTERVAL 1.0 // model time step in seconds, duty cycles are averaged over one interval
+#define HEATER_TRS_WINDOW 60 // comparison window in seconds
+#define HEATER_TRS_MIN_EXPECTED_RISE 0.5 // windows in which the model expects less rise are not judged
+#define HEATER_TRS_MIN_RESPONSE 0.25 // tolerance: the probe has to deliver at least this fraction of the expected rise ..
+#define HEATER_TRS_FAULT_WINDOWS 2 // .. in one of this many consecutive windows
+#define HEATER_TRS_MAX_DISTURBANCE 30.0 // heat sinks estimated by the disturbance observer lower the expected rise by up to this duty cycle
+
+// dry heating detection, needs a bath probe besides the heater mat (safety) probe. The heater is cut if the mat runs away from the bath.
+#define HEATER_DRY_GRADIENT_FACTOR 2.0 // the gradient may exceed the expected one by this factor ..
+#define HEATER_DRY_GRADIENT_MARGIN 10.0 // .. plus this margin in K ..
+#define HEATER_DRY_TIME 3.0 // .. for this many seconds
+
+// static heat loss feedforward. holding duty cycle = gain * (set value - ambient temp), gain is learned from settled periods
+#define HEATER_FF_DEFAULT_GAIN 0.0 // holding duty cycle per kelvin above ambient (%/K) until something was learned
+#define HEATER_FF_MAX_GAIN 10.0 // upper limit for the learned gain (%/K)
+#define HEATER_FF_DEFAULT_AMBIENT_TEMP 20.0 // upper limit for the ambient temp taken from the probes at startup (guards against warm restarts)
+#define HEATER_FF_AMBIENT_WINDOW 600.0 // with the heater off, the ambient temp follows a warmer probe if it changed less ..
+#define HEATER_FF_AMBIENT_STABLE_BAND 0.2 // .. than this many kelvin within one window of this many seconds ..
+#define HEATER_FF_AMBIENT_RISE_RATE 0.25 // .. by this fraction of the difference per window
+#define HEATER_FF_SETTLE_BAND 0.5 // process value has to stay within +- this band around the set value to count as settled
+#define HEATER_FF_SETTLE_TIME 120.0 // length of a learning window in seconds
+#define HEATER_FF_MIN_TEMP_DIFF 5.0 // don't learn if the set value is closer than this to ambient temp
+#define HEATER_FF_LEARNING_RATE 0.5 // weight of a new estimate against the old gain
+#define HEATER_FF_STORE_INTERVAL (30 * 60) // min time in seconds between two eeprom writes of the learned gains
+
+// first order plus dead time plant model used by smith predictor and disturbance observer. Time constant and dead time are user settings,
+// the default time constant is gain * heat capacity per % of the nominal power.
+#define HEATER_MODEL_DEFAULT_GAIN 0.5 // model gain (K per % duty cycle) until a heat loss feedforward gain was learned
+#define HEATER_MODEL_MAX_GAIN 5.0 // upper limit of the model gain derived from the learned feedforward gain
+
+// heater mat node of the plant model, shared by the dry heating detection and the mpc (mpc_table_script/mpctable.py reads it from here)
+#define HEATER_MAT_GRADIENT_PER_DUTY 0.3 // mat - bath gradient in K per % duty cycle with liquid on the mat
+#define HEATER_MAT_TAU 30.0 // time constant of the gradient after a power change in seconds
+
+// Smith predictor for the dead time between heater and controlling probe (mixing delay of the bath probe)
+#define HEATER_SMITH_DELAY_SLOTS 64 // length of the duty cycle delay line, has to be a power of two
+#define HEATER_SMITH_SLOT_TIME 1.0 // seconds per delay line slot. max dead time = slots * slot time
+
+// recipe engine. Sequence of set point ramps, holds and stirrer changes stored in eeprom.
+#define RCP_MAX_SEGMENTS 10
+#define RCP_RAMP_SETTLE_BAND 0.5 // a ramp segment ends when the process value is within +- band of its target
+
+// disturbance observer. Estimates unmodelled heat sinks (cold boards, fresh etchant) in % duty cycle from the model residual.
+#define HEATER_DOB_INTERVAL 1.0 // observer update interval in seconds. temperatures and duty cycles are averaged over one interval
+#define HEATER_DOB_FILTER_TC 30.0 // time constant of the estimate low pass in seconds
+#define HEATER_DOB_MAX_COMPENSATION 50.0 // max compensating duty cycle
+
+// time to set point estimation during heat up
+#define ETA_SAMPLE_INTERVAL 5.0 // seconds between two samples of the heat up curve
+#define ETA_SLOPE_FILTER_TC 30.0 // time constant of the slope low pass in seconds
+#define ETA_FIT_FORGET 0.97 // weight of the older samples per new sample in the model fit (~3 minutes memory)
+#define ETA_MIN_SAMPLES 6 // min samples before the model fit is used
+#define ETA_MIN_FIT_SPAN 0.5 // min standard deviation of the sampled temperatures in K for a usable fit
+#define ETA_MIN_SLOPE 0.0005 // min slope in K/s for the extrapolation, below the set point counts as out of reach
+
 // -------------------- stirrer -------------------------------------------------------------------------
 // 25khz pwm
 #define STIRRER_FAN_PWM_PRESCALE 1 // must be one out of {1, 8, 64, 256, 1024}
 #define STIRRER_FAN_PWM_TOP 160 // 16 bit uint, determines PWM resolution
 
+// fan tachometer. Pin change interrupt on a free pin, the stock mainboard has no tach net. Only define FAN_TACH with the tach wire connected,
+// the self-test fails without tach pulses.
+//#define FAN_TACH
+#define FAN_TACH_PORT PORTC
+#define FAN_TACH_DDR DDRC
+#define FAN_TACH_PIN PINC
+#define FAN_TACH_BIT PORTC0
+#define FAN_TACH_PCMSK PCMSK2
+#define FAN_TACH_PCINT PCINT16
+#define FAN_TACH_PCIE PCIE2
+#define FAN_TACH_vect PCINT2_vect
+#define FAN_TACH_PULSES_PER_REV 2 // standard pc fans
+#define FAN_TACH_MAX_RPM 3000.0 // rated speed of the fan, 100% fan speed in closed loop mode
+
+// closed loop fan speed control. The speed setting is a fraction of FAN_TACH_MAX_RPM.
+#define FAN_RPM_FILTER_TC 1.0 // time constant of the rpm low pass in seconds
+#define FAN_CTL_KP 0.005 // % duty cycle per rpm
+#define FAN_CTL_KI 0.005 // % duty cycle per rpm and second
+#define FAN_MIN_DUTY_CYCLE 20 // most fans stop below this duty cycle
+#define FAN_STALL_RPM 200.0 // a fan running slower than this at a duty cycle > 0 is considered stalled
+#define FAN_STALL_TIME 5.0 // seconds below stall rpm until FAN_STALL error is triggered, covers spin up
+
+// automatic fan curve. Load is the heater duty cycle or the load of an enclosure probe, whichever is higher.
+#define FAN_CURVE_LOAD_LOW 10.0 // idle speed up to this load in %
+#define FAN_CURVE_LOAD_HIGH 80.0 // full speed from this load in %
+#define FAN_CURVE_HYSTERESIS 10.0 // load drop in % until the fan slows down
+#define FAN_CURVE_FILTER_TC 30.0 // time constant of the load low pass in seconds
+#define FAN_CURVE_SLEW_RATE 2.0 // max fan speed change in %/s
+//#define FAN_CURVE_TPROBE 2 // spare probe inside the enclosure, probe must be present and configured
+#define FAN_CURVE_TEMP_LOW 35.0 // enclosure temperature at 0% load
+#define FAN_CURVE_TEMP_HIGH 50.0 // enclosure temperature at 100% load
+
+// agitation waveform generator. Modulates the stirrer speed to break up the boundary layer at the board.
+#define AGT_SLEW_RATE 40.0 // max stirrer duty cycle change in %/s, soft start / stop keeps the stir bar coupled
+
 // --------------------- display / shift register -------------------------------------------------------
 
 #define SRD_DIGITS		6
@@ -146,6 +323,14 @@ SOFTWARE.
 #define PID_COARSE_CHANGE_PER_ROTENC_STEP 0.1
 #define PID_FINE_CHANGE_PER_ROTENC_STEP 0.005
 #define STIRRER_DC_CHANGE_PER_STEP 1
+#define TIME_CHANGE_PER_ROTENC_STEP 1.0
+#define DUTY_CYCLE_CHANGE_PER_ROTENC_STEP 0.5
+#define RCP_HOLD_CHANGE_PER_ROTENC_STEP 10 // seconds
+#define STIRRER_PERIOD_CHANGE_PER_ROTENC_STEP 0.5 // seconds
+#define STIRRER_DEPTH_CHANGE_PER_ROTENC_STEP 5
+#define HEATER_TPROP_WINDOW_CHANGE_PER_ROTENC_STEP 0.5 // seconds
+#define ECO_TIMEOUT_CHANGE_PER_ROTENC_STEP 5
+#define PID_D_FILTER_CUTOFF_FACTOR_PER_ROTENC_STEP 1.05 // multiplicative, ~47 steps per decade of the d filter cutoff
 
 // -------------------- switch --------------------------------------------------------------------------
 
@@ -162,7 +347,7 @@ SOFTWARE.
 
 // -------------------- app timer ------------------------------------------------------------------------------------------------
 // one main tick every 100us
-#define APP_TIMER_MAX_CALLBACKS 4
+#define APP_TIMER_MAX_CALLBACKS 8
 #define APP_TIMER_BASE_CLOCK 99
 #define APP_TIMER_PRESCALE APP_TIMER_PRESCALE_8
 #define APP_TIMER_RESOLUTION APP_TIMER_RES_64_BIT
@@ -172,6 +357,26 @@ SOFTWARE.
 #define APP_USER_LOOP_INTERVAL 0.04 // ~25hz
 #define APP_ROT_ENC_UPDATE_INTERVAL 0.001 // every 1 ms
 #define APP_BUTTON_UPDATE_INTERVAL 0.005 // every 5 ms
+#define APP_RECIPE_UPDATE_INTERVAL 1.0 // every second
+#define APP_AGITATION_UPDATE_INTERVAL 0.02 // ~50hz
+#define APP_FAN_UPDATE_INTERVAL 0.25 // 4hz
+#define APP_HEATER_OUTPUT_INTERVAL 0.02 // one 50hz mains cycle, resolution of the software heater outputs
+#define APP_MAIN_ALTERNATE_TIME 2.0 // seconds each field of the main screen is shown when two fields alternate
+
+// degraded mode: the heater is held off on a fault, recoverable faults clear after this fault free time
+#define APP_FAULT_RECOVER_TIME 1.0 // seconds, open / short circuit and min temp faults
+#define APP_FAULT_RECOVER_TIME_IMPLAUSIBLE 5.0 // seconds, the plausibility filter needs time to follow the probe again
+#define APP_FAULT_HISTORY_SIZE 8 // last faults shown in the stats menu
+
+// power-on self-test of the adc, the heater path and the fan (tach). Comment out APP_SELF_TEST to skip it, a button press skips it at startup.
+#define APP_SELF_TEST
+#define APP_SELF_TEST_ADC_SAMPLES 16 // raw readings per probe ..
+#define APP_SELF_TEST_ADC_MAX_SPREAD 8 // .. may differ by this many LSB
+#define APP_SELF_TEST_PULSE_ENERGY 150.0 // J, heater pulse at full nominal power, raises the heater mat by a few K
+#define APP_SELF_TEST_MIN_RISE 0.5 // K the safety probe has to rise ..
+#define APP_SELF_TEST_RESPONSE_TIME 10.0 // .. within this time after the start of the pulse in seconds
+#define APP_SELF_TEST_FAN_MIN_PULSES 4 // tach pulses of the fan at full speed within the response time
+#define APP_SELF_TEST_PASS_TIME 2.0 // seconds "PASS" is shown
 
 // -------------------- default user-adjustable settings -------------------------------------------------------------------------
 
@@ -182,9 +387,34 @@ SOFTWARE.
 #define SETTINGS_DEFAULT_HEATER_PID_TD 5.00
 #define SETTINGS_DEFAULT_HEATER_PID_OFFSET 0.0
 #define SETTINGS_DEFAULT_HEATER_PID_I_CLAMP 1.0
-#define SETTINGS_DEFAULT_HEATER_PID_D_SMOOTHING_FACTOR 0.9
+#define SETTINGS_DEFAULT_HEATER_PID_D_FILTER_CUTOFF 1.0
+#define SETTINGS_DEFAULT_HEATER_PID_D_FILTER_Q 0.707 // butterworth
+#define SETTINGS_DEFAULT_HEATER_PID_SP_WEIGHT_P 1.0 // 1.0 and 0.0 are the classic PID with derivative on measurement
+#define SETTINGS_DEFAULT_HEATER_PID_SP_WEIGHT_D 0.0
+#define SETTINGS_DEFAULT_HEATER_PID_SP_FILTER_TC 0.0 // set point prefilter disabled
+#define SETTINGS_DEFAULT_HEATER_PID_VELOCITY_ONOFF FALSE // positional algorithm
+#define SETTINGS_DEFAULT_HEATER_PID_GS_ONOFF FALSE // gain table entries default to the PID defaults above
+#define SETTINGS_DEFAULT_HEATER_SMITH_ONOFF FALSE
+#define SETTINGS_DEFAULT_HEATER_MODEL_TAU HEATER_MODEL_DEFAULT_TAU
+#define SETTINGS_DEFAULT_HEATER_MODEL_DEAD_TIME 20.0
+#define SETTINGS_DEFAULT_HEATER_DOB_ONOFF FALSE
+#define SETTINGS_DEFAULT_HEATER_DOB_THRESHOLD 5.0 // estimates within +- threshold are considered noise / model error and not compensated
+#define SETTINGS_DEFAULT_HEATER_MPC_ONOFF FALSE // explicit mpc instead of the pid. Tables are generated by mpc_table_script/mpctable.py for the identified model and cover set points of 30 to 60 degC at 20 degC ambient by default, the pid runs outside of MPC_TABLE_SET_POINT_MIN .. MPC_SET_POINT_MAX.
+#define SETTINGS_DEFAULT_HEATER_OUTPUT_MODE HEATER_OUTPUT_PWM
+#define SETTINGS_DEFAULT_HEATER_TPROP_WINDOW 5.0
 #define SETTINGS_DEFAULT_CONTROLLING_TPROBE HEATER_SAFETY_TPROBE
+#define SETTINGS_DEFAULT_ZONE_TARGET_TEMP SETTINGS_DEFAULT_HEATER_TARGET_TEMP
+#define SETTINGS_DEFAULT_ZONE_TPROBE 2 // mat probe of the zone heater, not the bath probe
+#define SETTINGS_DEFAULT_STIRRER_WAVEFORM AGT_WAVE_CONSTANT
+#define SETTINGS_DEFAULT_STIRRER_PERIOD 10.0
+#define SETTINGS_DEFAULT_STIRRER_DEPTH 50
 #define SETTINGS_DEFAULT_FAN_DUTY_CYCLE 50
+#define SETTINGS_DEFAULT_FAN_CLOSED_LOOP_ONOFF FALSE // needs the tach wire, see FAN_TACH
+#define SETTINGS_DEFAULT_FAN_CURVE_ONOFF TRUE // fan duty cycle setting is the full load speed
+#define SETTINGS_DEFAULT_FAN_IDLE_DUTY_CYCLE 0
+#define SETTINGS_DEFAULT_ECO_ONOFF FALSE
+#define SETTINGS_DEFAULT_ECO_TIMEOUT 60 // minutes without input until standby
+#define SETTINGS_DEFAULT_ECO_TEMP 30.0 // standby set point
 
 //////////////////////////////////////////////////////// HELPER STUFF //////////////////////////////////////////////////////
 // num thermistors
@@ -212,6 +442,8 @@ SOFTWARE.
 #define TSENS_PROBE_3_PRESENT 0
 #endif
 
+#define TSENS_MAX_PROBES 4
+
 typedef enum {
 	EC_SUCCESS = 0,
 	EC_THERMISTOR_OPEN_CIRCUIT = 1,
@@ -219,10 +451,55 @@ typedef enum {
 	EC_THERMISTOR_NOT_RESPONDING = 3,
 	EC_NO_CONTROLLING_TPROBE = 4,
 	EC_THERMISTOR_MAX_TEMP = 5,
-	EC_THERMISTOR_MIN_TEMP = 6
+	EC_THERMISTOR_MIN_TEMP = 6,
+	EC_FAN_STALL = 7,
+	EC_THERMISTOR_IMPLAUSIBLE = 8,
+	EC_DRY_HEATING = 9
 } ErrorCode;
 
+// --------------------- temp sensor -----------------------------------------
+// max dT/dt in K/s of the probes
+#define TSENS_PROBE_0_MAX_RATE (HEATER_NOMINAL_POWER / TSENS_PROBE_0_HEAT_CAPACITY * TSENS_PLAUSIBILITY_RATE_MARGIN)
+#define TSENS_PROBE_1_MAX_RATE (HEATER_NOMINAL_POWER / TSENS_PROBE_1_HEAT_CAPACITY * TSENS_PLAUSIBILITY_RATE_MARGIN)
+#define TSENS_PROBE_2_MAX_RATE (HEATER_NOMINAL_POWER / TSENS_PROBE_2_HEAT_CAPACITY * TSENS_PLAUSIBILITY_RATE_MARGIN)
+#define TSENS_PROBE_3_MAX_RATE (HEATER_NOMINAL_POWER / TSENS_PROBE_3_HEAT_CAPACITY * TSENS_PLAUSIBILITY_RATE_MARGIN)
+
 // --------------------- PID -------------------------------------------------
 #define PID_DELTA_T APP_PID_LOOP_INTERVAL
 
+// --------------------- heater feedforward ----------------------------------
+#define HEATER_FF_SETTLE_TICKS ((uint16_t)(HEATER_FF_SETTLE_TIME / PID_DELTA_T))
+
+// --------------------- plant model -----------------------------------------
+#define HEATER_MODEL_DEFAULT_TAU (HEATER_MODEL_DEFAULT_GAIN * 100.0 / HEATER_NOMINAL_POWER * HEATER_BATH_HEAT_CAPACITY)
+
+// --------------------- smith predictor -------------------------------------
+#define HEATER_SMITH_SLOT_TICKS ((uint8_t)(HEATER_SMITH_SLOT_TIME / PID_DELTA_T))
+
+// --------------------- disturbance observer --------------------------------
+#define HEATER_DOB_TICKS ((uint8_t)(HEATER_DOB_INTERVAL / PID_DELTA_T))
+
+// --------------------- thermal runaway supervisor --------------------------
+#define HEATER_TRS_TICKS ((uint8_t)(HEATER_TRS_INTERVAL / PID_DELTA_T))
+#define HEATER_TRS_WINDOW_INTERVALS ((uint8_t)(HEATER_TRS_WINDOW / HEATER_TRS_INTERVAL))
+
+// --------------------- heater output ---------------------------------------
+#define HEATER_TPROP_MIN_SWITCH_TICKS ((int32_t)(HEATER_TPROP_MIN_SWITCH_TIME / APP_HEATER_OUTPUT_INTERVAL + 0.5))
+#define HEATER_SOFT_PWM_TICKS ((uint8_t)(HEATER_SOFT_PWM_PERIOD / APP_HEATER_OUTPUT_INTERVAL + 0.5))
+#define HEATER_VSENSE_FILTER_ALPHA (APP_PID_LOOP_INTERVAL / (HEATER_VSENSE_FILTER_TC + APP_PID_LOOP_INTERVAL))
+
+// --------------------- fan control -----------------------------------------
+#define FAN_RPM_FILTER_ALPHA (APP_FAN_UPDATE_INTERVAL / (FAN_RPM_FILTER_TC + APP_FAN_UPDATE_INTERVAL))
+#define FAN_CURVE_FILTER_ALPHA (APP_FAN_UPDATE_INTERVAL / (FAN_CURVE_FILTER_TC + APP_FAN_UPDATE_INTERVAL))
+
+// --------------------- degraded mode ---------------------------------------
+#define APP_FAULT_RECOVER_TICKS ((uint8_t)(APP_FAULT_RECOVER_TIME / PID_DELTA_T))
+#define APP_FAULT_RECOVER_TICKS_IMPLAUSIBLE ((uint8_t)(APP_FAULT_RECOVER_TIME_IMPLAUSIBLE / PID_DELTA_T))
+
+// --------------------- self-test -------------------------------------------
+#define APP_SELF_TEST_PULSE_TIME (APP_SELF_TEST_PULSE_ENERGY / HEATER_NOMINAL_POWER)
+
+// --------------------- agitation -------------------------------------------
+#define AGT_SLEW_STEP ((int16_t)(AGT_SLEW_RATE * APP_AGITATION_UPDATE_INTERVAL * 128.0)) // in 1/128 % per update
+
 #endif /* CONFIG_H_ */
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+#include "dist_observer.h"
+#include "config.h"
+#include "my_util.h"
+#include <math.h>
+
+void dob_init(dob_state_t* state, float gain, float tau)
+{
+	tm_init(&state->model, gain, tau, HEATER_DOB_INTERVAL);
+	state->filter_alpha = exp(-HEATER_DOB_INTERVAL / HEATER_DOB_FILTER_TC);
+	dob_reset(state);
+}
+
+void dob_set_params(dob_state_t* state, float gain, float tau)
+{
+	tm_set_params(&state->model, gain, tau, HEATER_DOB_INTERVAL);
+}
+
+void dob_step(dob_state_t* state, float process_value, float ambient_temp, float delayed_duty)
+{
+	// average over one interval, a single control step is dominated by sensor noise
+	state->temp_sum += process_value;
+	state->duty_sum += delayed_duty;
+	if(++state->ticks < HEATER_DOB_TICKS)
+		return;
+	float rise = state->temp_sum / state->ticks - ambient_temp;
+	float duty = state->duty_sum / state->ticks;
+	state->temp_sum = 0.0;
+	state->duty_sum = 0.0;
+	state->ticks = 0;
+	if(state->valid)
+	{
+		// one step prediction from the last measured rise
+		tm_reset(&state->model, state->last_rise);
+		float residual = rise - tm_step(&state->model, duty);
+		// duty cycle which would have caused the residual within one interval
+		float disturbance = residual / ((1.0 - state->model.alpha) * state->model.gain);
+		state->estimate = state->filter_alpha * state->estimate + (1.0 - state->filter_alpha) * disturbance;
+	}
+	state->last_rise = rise;
+	state->valid = TRUE;
+}
+
+float dob_compensation(dob_state_t* state, float threshold)
+{
+	// soft deadband: only the part of the estimate beyond the threshold is compensated
+	float comp = 0.0;
+	if(state->estimate > threshold)
+		comp = threshold - state->estimate;
+	else if(state->estimate < -threshold)
+		comp = -threshold - state->estimate;
+	return fmax(fmin(comp, HEATER_DOB_MAX_COMPENSATION), -HEATER_DOB_MAX_COMPENSATION);
+}
+
+void dob_reset(dob_state_t* state)
+{
+	state->temp_sum = 0.0;
+	state->duty_sum = 0.0;
+	state->ticks = 0;
+	state->last_rise = 0.0;
+	state->valid = FALSE;
+	state->estimate = 0.0;
+}
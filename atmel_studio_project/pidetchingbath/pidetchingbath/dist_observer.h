@@ -0,0 +1,52 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef DIST_OBSERVER_H_
+#define DIST_OBSERVER_H_
+#include <stdint.h>
+#include "thermal_model.h"
+
+// Disturbance observer. Compares the measured temperature rise above ambient with the rise predicted by the
+// plant model for the applied duty cycle. The residual is converted to an equivalent duty cycle, so sudden
+// heat sinks like a cold board or fresh etchant can be compensated before the integrator catches up.
+typedef struct
+{
+	tm_state_t model;		// plant model with the observer interval as time step
+	float temp_sum;			// process values summed over the current interval
+	float duty_sum;			// delayed duty cycles summed over the current interval
+	uint8_t ticks;			// control steps in the current interval
+	float last_rise;		// averaged temperature rise above ambient of the last interval
+	uint8_t valid;			// last_rise is valid
+	float filter_alpha;		// estimate low pass factor
+	float estimate;			// estimated disturbance in % duty cycle, negative for heat sinks
+} dob_state_t;
+
+void dob_init(dob_state_t* state, float gain, float tau);
+void dob_set_params(dob_state_t* state, float gain, float tau);
+void dob_step(dob_state_t* state, float process_value, float ambient_temp, float delayed_duty);
+float dob_compensation(dob_state_t* state, float threshold);
+void dob_reset(dob_state_t* state);
+
+#endif /* DIST_OBSERVER_H_ */
@@ -0,0 +1,50 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#include "dry_detect.h"
+#include "my_util.h"
+
+void dry_reset(dry_state_t* state, float gradient)
+{
+	state->expected_gradient = gradient;
+	state->fault_time = 0.0;
+}
+
+ErrorCode dry_step(dry_state_t* state, float mat_temp, float bath_temp, float duty, float dt)
+{
+	// the gradient settles with the mat time constant after a power change
+	float target = HEATER_MAT_GRADIENT_PER_DUTY * fmax(duty, 0.0);
+	state->expected_gradient += (dt / (HEATER_MAT_TAU + dt)) * (target - state->expected_gradient);
+	
+	float gradient = mat_temp - bath_temp;
+	if(gradient > state->expected_gradient * HEATER_DRY_GRADIENT_FACTOR + HEATER_DRY_GRADIENT_MARGIN)
+		state->fault_time += dt;
+	else
+		state->fault_time = 0.0;
+	
+	if(state->fault_time >= HEATER_DRY_TIME)
+		return EC_DRY_HEATING;
+	return EC_SUCCESS;
+}
@@ -0,0 +1,45 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef DRY_DETECT_H_
+#define DRY_DETECT_H_
+#include <stdint.h>
+#include "config.h"
+
+// Dry heating detection. With liquid on the mat, the mat to bath temperature gradient follows the applied power
+// (HEATER_MAT_GRADIENT_PER_DUTY, lagging with the mat time constant). If the bath level dropped or the tank was lifted off,
+// the mat heats up while the bath stays flat and the gradient leaves the expected band.
+typedef struct
+{
+	float expected_gradient;	// mat - bath gradient expected for the applied duty cycle
+	float fault_time;			// time the gradient has been out of the band
+} dry_state_t;
+
+// gradient: current mat - bath temperature difference
+void dry_reset(dry_state_t* state, float gradient);
+// called every control step while the heater is on
+ErrorCode dry_step(dry_state_t* state, float mat_temp, float bath_temp, float duty, float dt);
+
+#endif /* DRY_DETECT_H_ */
@@ -0,0 +1,81 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#include "energy.h"
+#include "my_util.h"
+
+void egy_init(egy_state_t* state, const egy_counter_t* lifetime)
+{
+	state->lifetime = *lifetime;
+	state->lifetime_dirty = FALSE;
+	egy_reset_session(state);
+}
+
+void egy_reset_session(egy_state_t* state)
+{
+	state->session.energy = 0;
+	state->session.on_time = 0;
+	state->energy_fraction = 0.0;
+	state->on_time_fraction = 0.0;
+}
+
+void egy_step(egy_state_t* state, float duty_cycle, float dt)
+{
+	// a single step is far below the float resolution of the counters, so whole units are moved into integer counters
+	state->energy_fraction += HEATER_NOMINAL_POWER * fmax(fmin(duty_cycle, 100.0), 0.0) * 0.01 * dt;
+	state->on_time_fraction += dt;
+	if(state->energy_fraction >= 1.0)
+	{
+		uint32_t ws = (uint32_t)state->energy_fraction;
+		state->energy_fraction -= ws;
+		state->session.energy += ws;
+		state->lifetime.energy += ws;
+		state->lifetime_dirty = TRUE;
+	}
+	if(state->on_time_fraction >= 1.0)
+	{
+		state->on_time_fraction -= 1.0;
+		++state->session.on_time;
+		++state->lifetime.on_time;
+		state->lifetime_dirty = TRUE;
+	}
+}
+
+float egy_energy_wh(const egy_counter_t* counter)
+{
+	return counter->energy / 3600.0;
+}
+
+float egy_on_time_hours(const egy_counter_t* counter)
+{
+	return counter->on_time / 3600.0;
+}
+
+float egy_average_duty_cycle(const egy_counter_t* counter)
+{
+	if(!counter->on_time)
+		return 0.0;
+	return (100.0 * counter->energy) / ((float)HEATER_NOMINAL_POWER * counter->on_time);
+}
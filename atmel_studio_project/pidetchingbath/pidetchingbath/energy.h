@@ -0,0 +1,57 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef ENERGY_H_
+#define ENERGY_H_
+#include <stdint.h>
+#include "config.h"
+
+// Heater energy accounting. Integrates the applied duty cycle with the nominal heater power per session
+// (heater switched on until switched off) and over the lifetime of the device.
+typedef struct
+{
+	uint32_t energy;		// watt seconds
+	uint32_t on_time;		// seconds with the heater switched on
+} egy_counter_t;
+
+typedef struct
+{
+	egy_counter_t session;
+	egy_counter_t lifetime;			// persisted in eeprom
+	float energy_fraction;			// watt seconds not yet added to the counters
+	float on_time_fraction;			// seconds not yet added to the counters
+	uint8_t lifetime_dirty;			// lifetime counters changed since the last eeprom write
+} egy_state_t;
+
+void egy_init(egy_state_t* state, const egy_counter_t* lifetime);
+void egy_reset_session(egy_state_t* state);
+// called every control step while the heater is switched on, duty cycle in percent of the nominal power
+void egy_step(egy_state_t* state, float duty_cycle, float dt);
+float egy_energy_wh(const egy_counter_t* counter);
+float egy_on_time_hours(const egy_counter_t* counter);
+// average duty cycle in percent over the on time
+float egy_average_duty_cycle(const egy_counter_t* counter);
+
+#endif /* ENERGY_H_ */
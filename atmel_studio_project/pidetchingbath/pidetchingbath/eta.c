@@ -0,0 +1,94 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#include <math.h>
+#include "eta.h"
+#include "my_util.h"
+
+void eta_reset(eta_state_t* state, float temp)
+{
+	state->last_temp = temp;
+	state->elapsed = 0.0;
+	state->slope = 0.0;
+	state->s1 = 0.0;
+	state->sx = 0.0;
+	state->sy = 0.0;
+	state->sxx = 0.0;
+	state->sxy = 0.0;
+	state->samples = 0;
+}
+
+void eta_update(eta_state_t* state, float temp, float dt)
+{
+	state->elapsed += dt;
+	if(state->elapsed < ETA_SAMPLE_INTERVAL)
+		return;
+	
+	float slope = (temp - state->last_temp) / state->elapsed;
+	float x = 0.5 * (temp + state->last_temp);
+	state->slope += (state->elapsed / (ETA_SLOPE_FILTER_TC + state->elapsed)) * (slope - state->slope);
+	
+	// old samples fade out, the curve changes when the controller leaves full power
+	state->s1 = ETA_FIT_FORGET * state->s1 + 1.0;
+	state->sx = ETA_FIT_FORGET * state->sx + x;
+	state->sy = ETA_FIT_FORGET * state->sy + slope;
+	state->sxx = ETA_FIT_FORGET * state->sxx + x * x;
+	state->sxy = ETA_FIT_FORGET * state->sxy + x * slope;
+	if(state->samples < 0xFF)
+		++state->samples;
+	
+	state->last_temp = temp;
+	state->elapsed = 0.0;
+}
+
+float eta_estimate(const eta_state_t* state, float temp, float target)
+{
+	if(temp >= target)
+		return 0.0;
+	
+	// slope = a + b * T with b = -1 / tau and a = T_final / tau
+	if(state->samples >= ETA_MIN_SAMPLES)
+	{
+		float det = state->s1 * state->sxx - state->sx * state->sx;
+		// the samples have to span a temperature range, otherwise the fit is noise
+		if(det > state->s1 * state->s1 * ETA_MIN_FIT_SPAN * ETA_MIN_FIT_SPAN)
+		{
+			float b = (state->s1 * state->sxy - state->sx * state->sy) / det;
+			float a = (state->sy - b * state->sx) / state->s1;
+			if(b < 0.0)
+			{
+				float final_temp = -a / b;
+				if(final_temp <= target)
+					return ETA_UNKNOWN;
+				return log((final_temp - temp) / (final_temp - target)) / -b;
+			}
+		}
+	}
+	
+	// no usable fit yet, extrapolate the recent slope
+	if(state->samples > 0 && state->slope > ETA_MIN_SLOPE)
+		return (target - temp) / state->slope;
+	return ETA_UNKNOWN;
+}
@@ -0,0 +1,55 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef ETA_H_
+#define ETA_H_
+#include <stdint.h>
+#include "config.h"
+
+#define ETA_UNKNOWN -1.0
+
+// Time to set point estimation during heat up. The process value is sampled every ETA_SAMPLE_INTERVAL. A first order model
+// dT/dt = (T_final - T) / tau is fitted to the (temperature, slope) samples by exponentially weighted least squares,
+// which gives the time to reach the set point on the remaining heat up curve. Until the fit is usable, the recent slope is extrapolated.
+typedef struct
+{
+	float last_temp;		// temperature at the last sample
+	float elapsed;			// time since the last sample
+	float slope;			// filtered temperature slope in K/s
+	float s1;				// weighted sums of the model fit, x = temperature, y = slope
+	float sx;
+	float sy;
+	float sxx;
+	float sxy;
+	uint8_t samples;
+} eta_state_t;
+
+void eta_reset(eta_state_t* state, float temp);
+// called every control step while heating
+void eta_update(eta_state_t* state, float temp, float dt);
+// seconds until temp reaches target, ETA_UNKNOWN if it is not reachable or not known yet
+float eta_estimate(const eta_state_t* state, float temp, float target);
+
+#endif /* ETA_H_ */
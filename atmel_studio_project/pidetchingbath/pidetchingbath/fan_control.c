@@ -0,0 +1,89 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#include "fan_control.h"
+#include "app_timer.h"
+#include "my_util.h"
+
+void fctl_init(fctl_state_t* state)
+{
+	state->last_pulses = 0;
+	state->last_pulse_cycles = 0;
+	state->rpm = 0.0;
+	fctl_reset(state);
+}
+
+void fctl_reset(fctl_state_t* state)
+{
+	state->integrator = 0.0;
+	state->stall_time = 0.0;
+}
+
+void fctl_measure(fctl_state_t* state, uint16_t pulses, uint32_t last_pulse_cycles)
+{
+	float rpm = 0.0;
+	uint16_t new_pulses = pulses - state->last_pulses;
+	if(new_pulses > 0)
+	{
+		// time between the last pulses of two measurements covers exactly the new pulses. Gives a far better
+		// resolution than counting pulses per update at the low pulse rates of a fan.
+		float time = appt_cycles_to_seconds(last_pulse_cycles - state->last_pulse_cycles);
+		if(time > 0.0)
+			rpm = new_pulses * (60.0 / FAN_TACH_PULSES_PER_REV) / time;
+		state->last_pulses = pulses;
+		state->last_pulse_cycles = last_pulse_cycles;
+	}
+	state->rpm += FAN_RPM_FILTER_ALPHA * (rpm - state->rpm);
+}
+
+uint8_t fctl_step(fctl_state_t* state, float target_rpm)
+{
+	if(target_rpm <= 0.0)
+	{
+		state->integrator = 0.0;
+		return 0;
+	}
+	float error = target_rpm - state->rpm;
+	// linear duty cycle to speed guess, the integrator corrects it for the actual fan
+	float output = target_rpm * (100.0 / FAN_TACH_MAX_RPM) + FAN_CTL_KP * error + state->integrator;
+	// conditional integration, no windup at the duty cycle limits
+	if((output < 100.0 || error < 0.0) && (output > FAN_MIN_DUTY_CYCLE || error > 0.0))
+		state->integrator += FAN_CTL_KI * error * APP_FAN_UPDATE_INTERVAL;
+	return (uint8_t)(fmax(fmin(output, 100.0), FAN_MIN_DUTY_CYCLE) + 0.5);
+}
+
+void fctl_check_stall(fctl_state_t* state, uint8_t duty_cycle, ErrorCode* ec)
+{
+	if(duty_cycle > 0 && state->rpm < FAN_STALL_RPM)
+	{
+		state->stall_time += APP_FAN_UPDATE_INTERVAL;
+		if(state->stall_time > FAN_STALL_TIME)
+			*ec = EC_FAN_STALL;
+	}
+	else
+	{
+		state->stall_time = 0.0;
+	}
+}
@@ -0,0 +1,50 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef FAN_CONTROL_H_
+#define FAN_CONTROL_H_
+#include <stdint.h>
+#include "config.h"
+
+// Closed loop fan speed control from the tach signal. Called every APP_FAN_UPDATE_INTERVAL.
+typedef struct
+{
+	uint16_t last_pulses;			// tach pulse count of the last measurement
+	uint32_t last_pulse_cycles;		// app timer cycles at the last counted pulse
+	float rpm;						// filtered fan speed
+	float integrator;				// duty cycle correction of the feedforward guess
+	float stall_time;				// seconds below stall rpm
+} fctl_state_t;
+
+void fctl_init(fctl_state_t* state);
+void fctl_reset(fctl_state_t* state);
+// updates the filtered fan speed from the tach counters
+void fctl_measure(fctl_state_t* state, uint16_t pulses, uint32_t last_pulse_cycles);
+// returns the fan duty cycle for the target speed
+uint8_t fctl_step(fctl_state_t* state, float target_rpm);
+// sets ec to EC_FAN_STALL if the fan doesn't turn although it is driven
+void fctl_check_stall(fctl_state_t* state, uint8_t duty_cycle, ErrorCode* ec);
+
+#endif /* FAN_CONTROL_H_ */
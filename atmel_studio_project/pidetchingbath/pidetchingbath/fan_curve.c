@@ -0,0 +1,59 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#include "fan_curve.h"
+#include "my_util.h"
+
+void fcurve_init(fcurve_state_t* state, float output)
+{
+	state->load = 0.0;
+	state->held_load = 0.0;
+	state->output = output;
+}
+
+float fcurve_temp_load(float temp)
+{
+	return (temp - FAN_CURVE_TEMP_LOW) * (100.0 / (FAN_CURVE_TEMP_HIGH - FAN_CURVE_TEMP_LOW));
+}
+
+uint8_t fcurve_update(fcurve_state_t* state, float load, uint8_t idle_speed, uint8_t full_speed)
+{
+	// the heater duty cycle follows every pid correction, the fan only has to follow the average heat
+	state->load += FAN_CURVE_FILTER_ALPHA * (fmax(fmin(load, 100.0), 0.0) - state->load);
+	
+	// hysteresis: a rising load is followed at once to keep the driver cool, a falling load only after it dropped by the hysteresis band
+	if(state->load > state->held_load)
+		state->held_load = state->load;
+	else if(state->load < state->held_load - FAN_CURVE_HYSTERESIS)
+		state->held_load = state->load + FAN_CURVE_HYSTERESIS;
+	
+	float x = fmax(fmin((state->held_load - FAN_CURVE_LOAD_LOW) / (FAN_CURVE_LOAD_HIGH - FAN_CURVE_LOAD_LOW), 1.0), 0.0);
+	float target = idle_speed + x * ((float)full_speed - idle_speed);
+	
+	// rate limit, no audible hunting of the fan speed
+	float max_step = FAN_CURVE_SLEW_RATE * APP_FAN_UPDATE_INTERVAL;
+	state->output += fmax(fmin(target - state->output, max_step), -max_step);
+	return (uint8_t)(state->output + 0.5);
+}
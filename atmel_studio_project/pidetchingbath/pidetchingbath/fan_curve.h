@@ -0,0 +1,46 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef FAN_CURVE_H_
+#define FAN_CURVE_H_
+#include <stdint.h>
+#include "config.h"
+
+// Automatic fan speed from the cooling demand. Load 0..100% is mapped linearly from idle to full speed between
+// FAN_CURVE_LOAD_LOW and FAN_CURVE_LOAD_HIGH. Called every APP_FAN_UPDATE_INTERVAL.
+typedef struct
+{
+	float load;			// filtered load
+	float held_load;	// load after hysteresis
+	float output;		// rate limited fan speed
+} fcurve_state_t;
+
+void fcurve_init(fcurve_state_t* state, float output);
+// load of an enclosure temperature on the same 0..100% scale as the heater duty cycle
+float fcurve_temp_load(float temp);
+// returns the fan speed for the current load
+uint8_t fcurve_update(fcurve_state_t* state, float load, uint8_t idle_speed, uint8_t full_speed);
+
+#endif /* FAN_CURVE_H_ */
@@ -0,0 +1,95 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+#include "feedforward.h"
+#include "my_util.h"
+#include "config.h"
+
+void ff_init(ff_state_t* state, float gain, float ambient_temp)
+{
+	state->gain = gain;
+	state->ambient_temp = ambient_temp;
+	ff_reset_window(state);
+	ff_reset_ambient_window(state, ambient_temp);
+}
+
+void ff_set_gain(ff_state_t* state, float gain)
+{
+	state->gain = gain;
+	ff_reset_window(state);
+}
+
+float ff_output(ff_state_t* state, float set_value)
+{
+	return fmax(state->gain * (set_value - state->ambient_temp), 0.0);
+}
+
+uint8_t ff_learn(ff_state_t* state, float process_value, float set_value, float duty)
+{
+	// only settled periods count: process value within the settle band, unsaturated output and a constant set value
+	if(fabs(set_value - process_value) > HEATER_FF_SETTLE_BAND
+		|| duty <= HEATER_CONTROL_MIN || duty >= HEATER_CONTROL_MAX
+		|| set_value != state->window_set_value
+		|| (set_value - state->ambient_temp) < HEATER_FF_MIN_TEMP_DIFF)
+	{
+		ff_reset_window(state);
+		state->window_set_value = set_value;
+		return FALSE;
+	}
+	state->window_duty_sum += duty;
+	if(++state->window_ticks < HEATER_FF_SETTLE_TICKS)
+		return FALSE;
+	// window complete: the average duty cycle is the holding duty cycle at this temperature difference
+	float gain = (state->window_duty_sum / state->window_ticks) / (set_value - state->ambient_temp);
+	state->gain = fmax(fmin(state->gain + HEATER_FF_LEARNING_RATE * (gain - state->gain), HEATER_FF_MAX_GAIN), 0.0);
+	ff_reset_window(state);
+	return TRUE;
+}
+
+void ff_track_ambient(ff_state_t* state, float temp)
+{
+	// while the heater is off, the probes cool down towards ambient temperature
+	if(temp < state->ambient_temp)
+		state->ambient_temp = temp;
+	// in a warmer room the probes settle above the estimate: once they stay flat for a whole window, follow them slowly
+	state->ambient_window_time += PID_DELTA_T;
+	if(state->ambient_window_time >= HEATER_FF_AMBIENT_WINDOW)
+	{
+		if(fabs(temp - state->ambient_window_temp) < HEATER_FF_AMBIENT_STABLE_BAND)
+			state->ambient_temp += HEATER_FF_AMBIENT_RISE_RATE * (temp - state->ambient_temp);
+		ff_reset_ambient_window(state, temp);
+	}
+}
+
+void ff_reset_ambient_window(ff_state_t* state, float temp)
+{
+	state->ambient_window_temp = temp;
+	state->ambient_window_time = 0.0;
+}
+
+void ff_reset_window(ff_state_t* state)
+{
+	state->window_duty_sum = 0.0;
+	state->window_ticks = 0;
+}
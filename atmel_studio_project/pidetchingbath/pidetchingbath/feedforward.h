@@ -0,0 +1,51 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef FEEDFORWARD_H_
+#define FEEDFORWARD_H_
+#include <stdint.h>
+
+// static heat loss feedforward: holding duty cycle = gain * (set value - ambient temperature).
+// The gain is learned from periods in which the process value settled at the set value.
+typedef struct
+{
+	float gain;					// holding duty cycle per kelvin above ambient temperature
+	float ambient_temp;			// ambient temperature estimate
+	float ambient_window_temp;	// probe temperature at the start of the current ambient tracking window
+	float ambient_window_time;	// seconds the heater was off in the current ambient tracking window
+	float window_set_value;		// set value of the current learning window
+	float window_duty_sum;		// sum of the duty cycles applied during the current learning window
+	uint16_t window_ticks;		// number of settled control steps in the current learning window
+} ff_state_t;
+
+void ff_init(ff_state_t* state, float gain, float ambient_temp);
+void ff_set_gain(ff_state_t* state, float gain);
+float ff_output(ff_state_t* state, float set_value);
+uint8_t ff_learn(ff_state_t* state, float process_value, float set_value, float duty);
+void ff_track_ambient(ff_state_t* state, float temp);
+void ff_reset_ambient_window(ff_state_t* state, float temp);
+void ff_reset_window(ff_state_t* state);
+
+#endif /* FEEDFORWARD_H_ */
@@ -23,6 +23,9 @@ SOFTWARE.
  */ 
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include <math.h>
 #include "config.h"
 #include "heater.h"
 #include "my_util.h"
@@ -55,11 +58,115 @@ SOFTWARE.
 	#define HEATER_PWM_COMA_BITS (1 << COM2A1)
 #endif
 
+#ifdef HEATER_PWM_INVERSE
+	#define HEATER_PWM_COMB_BITS ((1 << COM2B1) | (1 << COM2B0))
+#else
+	#define HEATER_PWM_COMB_BITS (1 << COM2B1)
+#endif
+
 #define HEATER_PWM_WGM_BITS_A (1 << WGM20) // phase correct pwm
 
+#ifdef HEATER_VSENSE
+static uint16_t heater_supply_gain;	// (V_nom / V)^2 in Q12
+#endif
+
+// Timer2 runs while one of its outputs is in use
+#define HEATER_TIMER_ZONE0 (1 << 0)
+#define HEATER_TIMER_ZONE1 (1 << 1)
+static uint8_t heater_timer_users;
+
+// duty cycle in OCR2A steps (8.16 fixed point) and sigma-delta error, read by the overflow interrupt
+static volatile uint8_t heater_compval;
+static volatile uint16_t heater_compval_fraction;
+static uint16_t heater_dither_error;
+
+// software output modes
+static uint8_t heater_output_mode;
+static uint8_t heater_enabled;
+static uint16_t heater_duty16;
+static uint16_t heater_window_ticks;	// time proportioning window length
+static uint16_t heater_window_tick;		// position in the current window
+static uint16_t heater_on_ticks;		// on time of the current window
+static int32_t heater_window_error;		// on time carried over to the next window in 1/65536 ticks
+
+#if HEATER_NUM_ZONES > 2
+// software pwm zones
+static uint8_t heater_zones_enabled;	// bit per zone
+static uint8_t heater_zone_duty[HEATER_NUM_ZONES];
+static uint8_t heater_soft_pwm_tick;
+#endif
+
+static void heater_timer_start(uint8_t user)
+{
+	if(!heater_timer_users)
+	{
+		TCNT2 = 0x00;
+		TCCR2B |= HEATER_PWM_PRESCALE_BITS;
+	}
+	heater_timer_users |= user;
+}
+
+static void heater_timer_stop(uint8_t user)
+{
+	heater_timer_users &= ~user;
+	if(!heater_timer_users)
+	{
+		TCCR2B &= ~HEATER_PWM_PRESCALE_BITS;
+		TCNT2 = 0x00;
+	}
+}
+
+static void heater_set_pin(uint8_t on)
+{
+	#ifdef HEATER_PWM_INVERSE
+		on = !on;
+	#endif
+	if(on)
+		OC2A_PORT |= (1 << OC2A_BIT);
+	else
+		OC2A_PORT &= ~(1 << OC2A_BIT);
+}
+
+#if HEATER_NUM_ZONES > 2
+static void heater_zone_set_pin(uint8_t zone, uint8_t on)
+{
+	#ifdef HEATER_PWM_INVERSE
+		on = !on;
+	#endif
+	switch(zone)
+	{
+		case 2:
+			if(on)
+				HEATER_ZONE2_PORT |= (1 << HEATER_ZONE2_BIT);
+			else
+				HEATER_ZONE2_PORT &= ~(1 << HEATER_ZONE2_BIT);
+			break;
+		#if HEATER_NUM_ZONES > 3
+		case 3:
+			if(on)
+				HEATER_ZONE3_PORT |= (1 << HEATER_ZONE3_BIT);
+			else
+				HEATER_ZONE3_PORT &= ~(1 << HEATER_ZONE3_BIT);
+			break;
+		#endif
+	}
+}
+#endif
+
 void heater_init()
 {
 	TIMSK2 = 0x00;
+	heater_compval = 0;
+	heater_compval_fraction = 0;
+	heater_dither_error = 0;
+	heater_output_mode = HEATER_OUTPUT_PWM;
+	heater_enabled = FALSE;
+	heater_duty16 = 0;
+	heater_window_ticks = 1;
+	heater_timer_users = 0;
+	#ifdef HEATER_VSENSE
+		heater_supply_gain = 1 << 12;
+	#endif
 	// stop timer clock
 	TCCR2B &= ~HEATER_PWM_PRESCALE_BITS;
 	// enable phase correct, frequency correct pwm mode
@@ -81,43 +188,246 @@ void heater_init()
 	#else
 		OC2A_PORT &= ~(1 << OC2A_BIT);
 	#endif
+	
+	#if HEATER_NUM_ZONES > 1
+		// zone 1 on OC2B
+		OCR2B = 0x00;
+		OC2B_DDR |= (1 << OC2B_BIT);
+		#ifdef HEATER_PWM_INVERSE
+			OC2B_PORT |= (1 << OC2B_BIT);
+		#else
+			OC2B_PORT &= ~(1 << OC2B_BIT);
+		#endif
+	#endif
+	#if HEATER_NUM_ZONES > 2
+		// software pwm zones
+		heater_zones_enabled = 0;
+		heater_soft_pwm_tick = 0;
+		HEATER_ZONE2_DDR |= (1 << HEATER_ZONE2_BIT);
+		heater_zone_set_pin(2, FALSE);
+		#if HEATER_NUM_ZONES > 3
+			HEATER_ZONE3_DDR |= (1 << HEATER_ZONE3_BIT);
+			heater_zone_set_pin(3, FALSE);
+		#endif
+	#endif
 }
 
 void heater_shutdown()
 {
+	// disable dithering
+	TIMSK2 &= ~(1 << TOIE2);
 	// stop timer clock
 	TCCR2B &= ~HEATER_PWM_PRESCALE_BITS;
 	// reset duty cycle val
 	TCNT2 = 0x00;
 	OCR2A = 0x00;
 	// back to normal mode
-	TCCR2A &= ~(HEATER_PWM_COMA_BITS | HEATER_PWM_WGM_BITS_A);
+	TCCR2A &= ~(HEATER_PWM_COMA_BITS | HEATER_PWM_COMB_BITS | HEATER_PWM_WGM_BITS_A);
+	heater_timer_users = 0;
 	// disable output pin
 	OC2A_DDR &= ~(1 << OC2A_BIT);
 	OC2A_PORT &= ~(1 << OC2A_BIT);
+	#if HEATER_NUM_ZONES > 1
+		OCR2B = 0x00;
+		OC2B_DDR &= ~(1 << OC2B_BIT);
+		OC2B_PORT &= ~(1 << OC2B_BIT);
+	#endif
+	#if HEATER_NUM_ZONES > 2
+		heater_zones_enabled = 0;
+		HEATER_ZONE2_DDR &= ~(1 << HEATER_ZONE2_BIT);
+		HEATER_ZONE2_PORT &= ~(1 << HEATER_ZONE2_BIT);
+		#if HEATER_NUM_ZONES > 3
+			HEATER_ZONE3_DDR &= ~(1 << HEATER_ZONE3_BIT);
+			HEATER_ZONE3_PORT &= ~(1 << HEATER_ZONE3_BIT);
+		#endif
+	#endif
 }
 
 void heater_set_duty_cycle(uint8_t dc)
 {
-	uint16_t compval = ((uint16_t)umax8(umin8(dc, 100), 0) * 0xFF) / 100;
-	OCR2A = (uint8_t)compval;
+	heater_set_duty_cycle16((uint16_t)(((uint32_t)umin8(dc, 100) * HEATER_DUTY_CYCLE16_MAX) / 100));
 }
 
+void heater_set_duty_cycle16(uint16_t dc)
+{
+	#ifdef HEATER_VSENSE
+		// duty cycle is a fraction of the nominal power
+		dc = (uint16_t)umin32(((uint32_t)dc * heater_supply_gain) >> 12, HEATER_DUTY_CYCLE16_MAX);
+	#endif
+	// 0xFFFF * 0xFF fits into 24 bits: upper byte is the compare value, lower 16 bits the fraction
+	heater_duty16 = dc;
+	uint32_t compval = (uint32_t)dc * 0xFF;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		heater_compval = (uint8_t)(compval >> 16);
+		heater_compval_fraction = (uint16_t)compval;
+	}
+}
+
+#ifdef HEATER_VSENSE
+void heater_set_supply_voltage(float voltage)
+{
+	// implausible reading, better uncompensated than doubled power
+	if(voltage < HEATER_VSENSE_MIN_VOLTAGE || voltage > HEATER_VSENSE_MAX_VOLTAGE)
+	{
+		heater_supply_gain = 4096;
+		return;
+	}
+	float ratio = HEATER_VSENSE_NOMINAL_VOLTAGE / voltage;
+	heater_supply_gain = (uint16_t)(fmin(ratio * ratio, HEATER_VSENSE_MAX_GAIN) * 4096.0 + 0.5);
+}
+#endif
+
 void heater_on()
 {
-	TCNT2 = 0x00;
+	heater_enabled = TRUE;
+	heater_dither_error = 0;
+	if(heater_output_mode != HEATER_OUTPUT_PWM)
+	{
+		// pin is switched by heater_output_update, starting with a new window
+		heater_window_tick = 0;
+		heater_window_error = 0;
+		return;
+	}
 	#ifdef HEATER_PWM_INVERSE
 		OCR2A = 0xFF;
 	#else
 		OCR2A = 0x00;
 	#endif
 	TCCR2A |= HEATER_PWM_COMA_BITS;
-	TCCR2B |= HEATER_PWM_PRESCALE_BITS;
+	heater_timer_start(HEATER_TIMER_ZONE0);
+	// compare value update once per pwm period
+	TIMSK2 |= (1 << TOIE2);
 }
 
 void heater_off()
 {	
+	heater_enabled = FALSE;
+	TIMSK2 &= ~(1 << TOIE2);
 	TCCR2A &= ~HEATER_PWM_COMA_BITS;
-	TCCR2B &= ~HEATER_PWM_PRESCALE_BITS;	
-	TCNT2 = 0x00;
+	heater_timer_stop(HEATER_TIMER_ZONE0);
+	heater_set_pin(FALSE);
+}
+
+#if HEATER_NUM_ZONES > 1
+void heater_zone_on(uint8_t zone)
+{
+	if(zone == 1)
+	{
+		OCR2B = 0x00;
+		TCCR2A |= HEATER_PWM_COMB_BITS;
+		heater_timer_start(HEATER_TIMER_ZONE1);
+	}
+	#if HEATER_NUM_ZONES > 2
+	else
+	{
+		heater_zones_enabled |= (1 << zone);
+	}
+	#endif
+}
+
+void heater_zone_off(uint8_t zone)
+{
+	if(zone == 1)
+	{
+		TCCR2A &= ~HEATER_PWM_COMB_BITS;
+		heater_timer_stop(HEATER_TIMER_ZONE1);
+	}
+	#if HEATER_NUM_ZONES > 2
+	else
+	{
+		heater_zones_enabled &= ~(1 << zone);
+		heater_zone_set_pin(zone, FALSE);
+	}
+	#endif
+}
+
+void heater_zone_set_duty_cycle(uint8_t zone, uint8_t dc)
+{
+	#ifdef HEATER_VSENSE
+		dc = (uint8_t)umin32(((uint32_t)dc * heater_supply_gain) >> 12, 100);
+	#else
+		dc = umin8(dc, 100);
+	#endif
+	if(zone == 1)
+		OCR2B = (uint8_t)(((uint16_t)dc * 0xFF) / 100);
+	#if HEATER_NUM_ZONES > 2
+	else
+		heater_zone_duty[zone] = dc;
+	#endif
+}
+#endif
+
+void heater_set_output_mode(uint8_t mode, float window)
+{
+	heater_window_ticks = (uint16_t)fmax(window / APP_HEATER_OUTPUT_INTERVAL + 0.5, 1.0);
+	if(mode == heater_output_mode)
+		return;
+	// restart the heater with the new backend
+	uint8_t enabled = heater_enabled;
+	if(enabled)
+		heater_off();
+	heater_output_mode = mode;
+	if(enabled)
+		heater_on();
+}
+
+static void heater_output_update_zone0()
+{
+	if(!heater_enabled || heater_output_mode == HEATER_OUTPUT_PWM)
+		return;
+	if(heater_output_mode == HEATER_OUTPUT_BURST)
+	{
+		// first order sigma-delta on whole update intervals, the pin switches at most once per interval
+		uint16_t error = heater_dither_error + heater_duty16;
+		uint8_t on = error < heater_dither_error;
+		heater_dither_error = error;
+		heater_set_pin(on);
+		return;
+	}
+	
+	// time proportioning: on time of a window is computed at its start
+	if(heater_window_tick == 0)
+	{
+		int32_t on_time = (int32_t)((uint32_t)heater_duty16 * heater_window_ticks) + heater_window_error;
+		int32_t on_ticks = imax32(imin32((on_time + 0x8000) >> 16, heater_window_ticks), 0);
+		// pulses and gaps shorter than the min switch time are dropped, their energy is carried to the next window
+		if(on_ticks < HEATER_TPROP_MIN_SWITCH_TICKS)
+			on_ticks = 0;
+		else if(heater_window_ticks - on_ticks < HEATER_TPROP_MIN_SWITCH_TICKS)
+			on_ticks = heater_window_ticks;
+		heater_window_error = on_time - (on_ticks << 16);
+		heater_on_ticks = (uint16_t)on_ticks;
+	}
+	heater_set_pin(heater_window_tick < heater_on_ticks);
+	if(++heater_window_tick >= heater_window_ticks)
+		heater_window_tick = 0;
+}
+
+void heater_output_update()
+{
+	heater_output_update_zone0();
+	#if HEATER_NUM_ZONES > 2
+		// software pwm zones, on time in whole update intervals
+		for(uint8_t zone = 2; zone < HEATER_NUM_ZONES; ++zone)
+		{
+			if(heater_zones_enabled & (1 << zone))
+				heater_zone_set_pin(zone, heater_soft_pwm_tick < ((uint16_t)heater_zone_duty[zone] * HEATER_SOFT_PWM_TICKS) / 100);
+		}
+		if(++heater_soft_pwm_tick >= HEATER_SOFT_PWM_TICKS)
+			heater_soft_pwm_tick = 0;
+	#endif
+}
+
+// ------------------------------ ISR ------------------------------------
+ISR(TIMER2_OVF_vect)
+{
+	// overflow is at BOTTOM. In phase correct mode OCR2A is double buffered and updated at TOP, so the new value
+	// shapes the down slope of this period and the up slope of the next one. Every value still lasts exactly one
+	// period (TOP to TOP), so the average is unaffected. The fraction accumulates and adds one compare step
+	// whenever it overflows, so the average matches the 16 bit duty cycle.
+	uint16_t error = heater_dither_error + heater_compval_fraction;
+	uint8_t carry = error < heater_dither_error;
+	heater_dither_error = error;
+	OCR2A = heater_compval + carry;
 }
@@ -26,11 +26,39 @@ SOFTWARE.
 #ifndef HEATER_H_
 #define HEATER_H_
 #include <stdint.h>
+#include "config.h"
+
+#define HEATER_DUTY_CYCLE16_MAX 0xFFFF // 100% duty cycle of heater_set_duty_cycle16
+
+// output backends
+#define HEATER_OUTPUT_PWM 0		// hardware pwm on OC2A, MOSFET switched DC heaters
+#define HEATER_OUTPUT_TPROP 1	// time proportioning window with min on / off time, mechanical relays and SSRs
+#define HEATER_OUTPUT_BURST 2	// one on / off decision per update interval (full mains cycles), zero cross SSRs
+#define HEATER_NUM_OUTPUT_MODES 3
 
 void heater_init();
 void heater_shutdown();
 
 void heater_set_duty_cycle(uint8_t dc);
+// 16 bit duty cycle. The fraction below one OCR2A step is dithered across pwm periods (first order sigma-delta).
+void heater_set_duty_cycle16(uint16_t dc);
 void heater_on();
 void heater_off();
+
+#ifdef HEATER_VSENSE
+// measured heater supply voltage. Duty cycles set afterwards are scaled by (V_nom / V)^2, so they are a fraction of the nominal power.
+void heater_set_supply_voltage(float voltage);
+#endif
+
+#if HEATER_NUM_ZONES > 1
+// additional heater zones 1 .. HEATER_NUM_ZONES - 1. Zone 1 is the OC2B pwm, further zones are software pwm pins.
+void heater_zone_on(uint8_t zone);
+void heater_zone_off(uint8_t zone);
+void heater_zone_set_duty_cycle(uint8_t zone, uint8_t dc);
+#endif
+
+// window is the time proportioning period in seconds
+void heater_set_output_mode(uint8_t mode, float window);
+// software output modes, called every APP_HEATER_OUTPUT_INTERVAL
+void heater_output_update();
 #endif /* HEATER_H_ */
\ No newline at end of file
@@ -24,6 +24,9 @@ SOFTWARE.
 
 #include "menu_rendering.h"
 #include "srdisplay.h"
+#include "agitation.h"
+#include "heater.h"
+#include "recipe.h"
 #include "my_util.h"
 //#include <avr/pgmspace.h>
 
@@ -77,6 +80,102 @@ void mr_main_menu(uint8_t item_index)
 		case 6: // "STORE.S."
 			srd_set(0, SRD_CS); srd_set(1, SRD_CT); srd_set(2, SRD_CO); srd_set(3, SRD_CR); srd_set(4, SRD_CE | SRD_DOT); srd_set(5, SRD_CS | SRD_DOT);
 			break;
+		case 7: // "RECIP"
+			srd_set(0, SRD_CR); srd_set(1, SRD_CE); srd_set(2, SRD_CC); srd_set(3, SRD_CI); srd_set(4, SRD_CP);
+			break;
+		case 8: // "STATS"
+			srd_set(0, SRD_CS); srd_set(1, SRD_CT); srd_set(2, SRD_CA); srd_set(3, SRD_CT); srd_set(4, SRD_CS);
+			break;
+		case 9: // "ZONE"
+			srd_set(0, SRD_CZ); srd_set(1, SRD_CO); srd_set(2, SRD_CN); srd_set(3, SRD_CE);
+			break;
+	}
+}
+
+void mr_stats(uint8_t page, float value)
+{
+	// "E" energy in Wh (lifetime kWh), "H" on time in hours, "D" average duty cycle in percent. Lifetime pages have a dot after the letter.
+	uint8_t lifetime_dot = page >= 3 ? SRD_DOT : 0;
+	switch(page % 3)
+	{
+		case 0:
+			srd_set(0, SRD_CE | lifetime_dot);
+			srd_setfloat(value, 1, value < 1000.0 ? 1 : 0, 5);
+			break;
+		case 1:
+			srd_set(0, SRD_CH | lifetime_dot);
+			srd_setfloat(value, 1, value < 1000.0 ? 1 : 0, 5);
+			break;
+		case 2:
+			srd_set(0, SRD_CD | lifetime_dot);
+			srd_setfloat(value, 1, 1, 5);
+			break;
+	}
+}
+
+void mr_fault_count(uint16_t count)
+{
+	// "FC" number of faults since startup
+	srd_set(0, SRD_CF); srd_set(1, SRD_CC);
+	srd_setint16(count, 2, 4);
+}
+
+void mr_fault(ErrorCode error, uint8_t probe, uint16_t age_minutes)
+{
+	// "F" with error code, probe and minutes since the fault, e.g. "F81 12". Empty history entries show "F --".
+	srd_set(0, SRD_CF);
+	if(error == EC_SUCCESS)
+	{
+		srd_set(2, SRD_MINUS); srd_set(3, SRD_MINUS);
+		return;
+	}
+	srd_setint16(error, 1, 1);
+	if(probe < TSENS_MAX_PROBES)
+		srd_setint16(probe, 2, 1);
+	else
+		srd_set(2, SRD_MINUS);
+	srd_setint16(age_minutes, 3, 3);
+}
+
+void mr_zone_menu(uint8_t item_index)
+{
+	switch (item_index)
+	{
+		case 0: // "--"
+			srd_set(0, SRD_MINUS); srd_set(1, SRD_MINUS);
+			break;
+		default: // zone number, e.g. "ZONE 1"
+			srd_set(0, SRD_CZ); srd_set(1, SRD_CO); srd_set(2, SRD_CN); srd_set(3, SRD_CE);
+			srd_setint16(item_index, 5, 1);
+			break;
+	}
+}
+
+void mr_zone_edit_menu(uint8_t item_index)
+{
+	switch (item_index)
+	{
+		case 0: // "--"
+			srd_set(0, SRD_MINUS); srd_set(1, SRD_MINUS);
+			break;
+		case 1: // "ONOFF"
+			srd_set(0, SRD_CO); srd_set(1, SRD_CN); srd_set(2, SRD_CO); srd_set(3, SRD_CF); srd_set(4, SRD_CF);
+			break;
+		case 2: // "TG.TP"
+			srd_set(0, SRD_CT); srd_set(1, SRD_CG | SRD_DOT); srd_set(2, SRD_CT); srd_set(3, SRD_CP);
+			break;
+		case 3: // "T.SEL"
+			srd_set(0, SRD_CT | SRD_DOT); srd_set(1, SRD_CS); srd_set(2, SRD_CE); srd_set(3, SRD_CL);
+			break;
+		case 4: // "KP"
+			srd_set(0, SRD_CP);
+			break;
+		case 5: // "TI"
+			srd_set(0, SRD_CT); srd_set(1, SRD_CI);
+			break;
+		case 6: // "TD"
+			srd_set(0, SRD_CT); srd_set(1, SRD_CD);
+			break;
 	}
 }
 
@@ -99,8 +198,94 @@ void mr_heater_menu(uint8_t item_index)
 		case 4: // "PID"
 			srd_set(0, SRD_CP); srd_set(1, SRD_CI); srd_set(2, SRD_CD);
 			break;
-		case 5: // "OFFSET"
-			srd_set(0, SRD_CO); srd_set(1, SRD_CF); srd_set(2, SRD_CF); srd_set(3, SRD_CS);
+		case 5: // "OUT"
+			srd_set(0, SRD_CO); srd_set(1, SRD_CU); srd_set(2, SRD_CT);
+			break;
+		case 6: // "ECO"
+			srd_set(0, SRD_CE); srd_set(1, SRD_CC); srd_set(2, SRD_CO);
+			break;
+	}
+}
+
+void mr_heater_menu_eco(uint8_t item_index)
+{
+	switch (item_index)
+	{
+		case 0: // "--"
+			srd_set(0, SRD_MINUS); srd_set(1, SRD_MINUS);
+			break;
+		case 1: // "ONOFF"
+			srd_set(0, SRD_CO); srd_set(1, SRD_CN); srd_set(2, SRD_CO); srd_set(3, SRD_CF); srd_set(4, SRD_CF);
+			break;
+		case 2: // "IDLE"
+			srd_set(0, SRD_CI); srd_set(1, SRD_CD); srd_set(2, SRD_CL); srd_set(3, SRD_CE);
+			break;
+		case 3: // "TEMP"
+			srd_set(0, SRD_CT); srd_set(1, SRD_CE); srd_set(2, SRD_CN); srd_set(3, SRD_CN); srd_set(4, SRD_CP);
+			break;
+	}
+}
+
+void mr_heater_menu_eco_timeout(uint16_t minutes)
+{
+	srd_set(0, SRD_E | SRD_F);
+	srd_setint16((int16_t)minutes, 1, 5);
+}
+
+void mr_eco_standby()
+{
+	// "ECO"
+	srd_set(0, SRD_CE); srd_set(1, SRD_CC); srd_set(2, SRD_CO);
+}
+
+void mr_time_to_ready(float seconds)
+{
+	// "r  12": minutes until the bath is ready, "r ---" if the target is out of reach, "READY" when ready
+	if(seconds == 0.0)
+	{
+		srd_set(0, SRD_CR); srd_set(1, SRD_CE); srd_set(2, SRD_CA); srd_set(3, SRD_CD); srd_set(4, SRD_CY);
+		return;
+	}
+	srd_set(0, SRD_CR);
+	if(seconds < 0.0)
+	{
+		srd_set(3, SRD_MINUS); srd_set(4, SRD_MINUS); srd_set(5, SRD_MINUS);
+	}
+	else
+	{
+		srd_setint16((int16_t)fmin((seconds + 59.0) / 60.0, 9999.0), 2, 4);
+	}
+}
+
+void mr_heater_menu_output(uint8_t item_index)
+{
+	switch (item_index)
+	{
+		case 0: // "--"
+			srd_set(0, SRD_MINUS); srd_set(1, SRD_MINUS);
+			break;
+		case 1: // "TYPE"
+			srd_set(0, SRD_CT); srd_set(1, SRD_CY); srd_set(2, SRD_CP); srd_set(3, SRD_CE);
+			break;
+		case 2: // "PER"
+			srd_set(0, SRD_CP); srd_set(1, SRD_CE); srd_set(2, SRD_CR);
+			break;
+	}
+}
+
+void mr_heater_menu_output_mode(uint8_t mode)
+{
+	srd_set(0, SRD_E | SRD_F);
+	switch (mode)
+	{
+		case HEATER_OUTPUT_PWM: // "PULSE"
+			srd_set(1, SRD_CP); srd_set(2, SRD_CU); srd_set(3, SRD_CL); srd_set(4, SRD_CS); srd_set(5, SRD_CE);
+			break;
+		case HEATER_OUTPUT_TPROP: // "TPROP"
+			srd_set(1, SRD_CT); srd_set(2, SRD_CP); srd_set(3, SRD_CR); srd_set(4, SRD_CO); srd_set(5, SRD_CP);
+			break;
+		case HEATER_OUTPUT_BURST: // "BURST"
+			srd_set(1, SRD_CB); srd_set(2, SRD_CU); srd_set(3, SRD_CR); srd_set(4, SRD_CS); srd_set(5, SRD_CT);
 			break;
 	}
 }
@@ -115,6 +300,15 @@ void mr_stirrer_menu(uint8_t item_index)
 		case 1: // "SPEED"
 			srd_set(0, SRD_CS); srd_set(1, SRD_CP); srd_set(2, SRD_CE); srd_set(3, SRD_CE); srd_set(4, SRD_CD);
 			break;
+		case 2: // "SHAPE"
+			srd_set(0, SRD_CS); srd_set(1, SRD_CH); srd_set(2, SRD_CA); srd_set(3, SRD_CP); srd_set(4, SRD_CE);
+			break;
+		case 3: // "PER"
+			srd_set(0, SRD_CP); srd_set(1, SRD_CE); srd_set(2, SRD_CR);
+			break;
+		case 4: // "DEPTH"
+			srd_set(0, SRD_CD); srd_set(1, SRD_CE); srd_set(2, SRD_CP); srd_set(3, SRD_CT); srd_set(4, SRD_CH);
+			break;
 	}
 }
 
@@ -128,6 +322,18 @@ void mr_fan_menu(uint8_t item_index)
 		case 1: // "SPEED"
 		srd_set(0, SRD_CS); srd_set(1, SRD_CP); srd_set(2, SRD_CE); srd_set(3, SRD_CE); srd_set(4, SRD_CD);
 		break;
+		case 2: // "AUTO"
+		srd_set(0, SRD_CA); srd_set(1, SRD_CU); srd_set(2, SRD_CT); srd_set(3, SRD_CO);
+		break;
+		case 3: // "IDLE"
+		srd_set(0, SRD_CI); srd_set(1, SRD_CD); srd_set(2, SRD_CL); srd_set(3, SRD_CE);
+		break;
+		case 4: // "CLOOP"
+		srd_set(0, SRD_CC); srd_set(1, SRD_CL); srd_set(2, SRD_CO); srd_set(3, SRD_CO); srd_set(4, SRD_CP);
+		break;
+		case 5: // "RPM"
+		srd_set(0, SRD_CR); srd_set(1, SRD_CP); srd_set(2, SRD_CN); srd_set(3, SRD_CN);
+		break;
 	}
 }
 
@@ -181,8 +387,111 @@ void mr_heater_menu_pid(uint8_t item_index)
 		case 5: // "OFFSET"
 			srd_set(0, SRD_CO); srd_set(1, SRD_CF); srd_set(2, SRD_CF); srd_set(3, SRD_CS); srd_set(4, SRD_CE); srd_set(5, SRD_CT);
 			break;
-		case 6: // "DSF"
-			srd_set(0, SRD_CD); srd_set(1, SRD_CS); srd_set(2, SRD_CF);
+		case 6: // "D.FLT"
+			srd_set(0, SRD_CD | SRD_DOT); srd_set(1, SRD_CF); srd_set(2, SRD_CL); srd_set(3, SRD_CT);
+			break;
+		case 7: // "SP.b"
+			srd_set(0, SRD_CS); srd_set(1, SRD_CP | SRD_DOT); srd_set(2, SRD_CB);
+			break;
+		case 8: // "SP.C"
+			srd_set(0, SRD_CS); srd_set(1, SRD_CP | SRD_DOT); srd_set(2, SRD_CC);
+			break;
+		case 9: // "SP.FLT"
+			srd_set(0, SRD_CS); srd_set(1, SRD_CP | SRD_DOT); srd_set(2, SRD_CF); srd_set(3, SRD_CL); srd_set(4, SRD_CT);
+			break;
+		case 10: // "G.SCH"
+			srd_set(0, SRD_CG | SRD_DOT); srd_set(1, SRD_CS); srd_set(2, SRD_CC); srd_set(3, SRD_CH);
+			break;
+		case 11: // "SMITH"
+			srd_set(0, SRD_CS); srd_set(1, SRD_CN); srd_set(2, SRD_CN); srd_set(3, SRD_CI); srd_set(4, SRD_CT); srd_set(5, SRD_CH);
+			break;
+		case 12: // "DOB"
+			srd_set(0, SRD_CD); srd_set(1, SRD_CO); srd_set(2, SRD_CB);
+			break;
+		case 13: // "VELOC"
+			srd_set(0, SRD_CV); srd_set(1, SRD_CE); srd_set(2, SRD_CL); srd_set(3, SRD_CO); srd_set(4, SRD_CC);
+			break;
+		case 14: // "MPC"
+			srd_set(0, SRD_CN); srd_set(1, SRD_CN); srd_set(2, SRD_CP); srd_set(3, SRD_CC);
+			break;
+	}
+}
+
+void mr_heater_menu_pid_d_filter(uint8_t item_index)
+{
+	switch (item_index)
+	{
+		case 0: // "--"
+			srd_set(0, SRD_MINUS); srd_set(1, SRD_MINUS);
+			break;
+		case 1: // "FC"
+			srd_set(0, SRD_CF); srd_set(1, SRD_CC);
+			break;
+		case 2: // "Q"
+			srd_set(0, SRD_CQ);
+			break;
+	}
+}
+
+void mr_heater_menu_pid_smith(uint8_t item_index)
+{
+	switch (item_index)
+	{
+		case 0: // "--"
+			srd_set(0, SRD_MINUS); srd_set(1, SRD_MINUS);
+			break;
+		case 1: // "ONOFF"
+			srd_set(0, SRD_CO); srd_set(1, SRD_CN); srd_set(2, SRD_CO); srd_set(3, SRD_CF); srd_set(4, SRD_CF);
+			break;
+		case 2: // "TAU"
+			srd_set(0, SRD_CT); srd_set(1, SRD_CA); srd_set(2, SRD_CU);
+			break;
+		case 3: // "DEAD.T"
+			srd_set(0, SRD_CD); srd_set(1, SRD_CE); srd_set(2, SRD_CA); srd_set(3, SRD_CD | SRD_DOT); srd_set(4, SRD_CT);
+			break;
+	}
+}
+
+void mr_heater_menu_pid_dob(uint8_t item_index)
+{
+	switch (item_index)
+	{
+		case 0: // "--"
+			srd_set(0, SRD_MINUS); srd_set(1, SRD_MINUS);
+			break;
+		case 1: // "ONOFF"
+			srd_set(0, SRD_CO); srd_set(1, SRD_CN); srd_set(2, SRD_CO); srd_set(3, SRD_CF); srd_set(4, SRD_CF);
+			break;
+		case 2: // "THRES"
+			srd_set(0, SRD_CT); srd_set(1, SRD_CH); srd_set(2, SRD_CR); srd_set(3, SRD_CE); srd_set(4, SRD_CS);
+			break;
+	}
+}
+
+void mr_heater_menu_pid_gs(uint8_t item_index)
+{
+	switch (item_index)
+	{
+		case 0: // "--"
+			srd_set(0, SRD_MINUS); srd_set(1, SRD_MINUS);
+			break;
+		case 1: // "ONOFF"
+			srd_set(0, SRD_CO); srd_set(1, SRD_CN); srd_set(2, SRD_CO); srd_set(3, SRD_CF); srd_set(4, SRD_CF);
+			break;
+		default: // band set point and gain, e.g. "40 TI"
+			srd_setint16((int16_t)(HEATER_GS_FIRST_BAND_TEMP + ((item_index - 2) / 3) * HEATER_GS_BAND_TEMP_STEP), 0, 2);
+			switch((item_index - 2) % 3)
+			{
+				case 0:
+					srd_set(3, SRD_CP);
+					break;
+				case 1:
+					srd_set(3, SRD_CT); srd_set(4, SRD_CI);
+					break;
+				default:
+					srd_set(3, SRD_CT); srd_set(4, SRD_CD);
+					break;
+			}
 			break;
 	}
 }
@@ -235,10 +544,34 @@ void mr_heater_menu_pid_offset(float offset)
 	srd_setfloat(offset, 1, 2, 5);
 }
 
-void mr_heater_menu_pid_dsmooth(float dsmooth)
+void mr_heater_menu_pid_d_filter_param(float value)
+{
+	srd_set(0, SRD_E | SRD_F);
+	srd_setfloat(value, 1, 3, 5);
+}
+
+void mr_heater_menu_pid_sp_weight(float weight)
+{
+	srd_set(0, SRD_E | SRD_F);
+	srd_setfloat(weight, 1, 2, 5);
+}
+
+void mr_heater_menu_pid_sp_filter_tc(float tc)
 {
 	srd_set(0, SRD_E | SRD_F);
-	srd_setfloat(dsmooth, 1, 3, 5);
+	srd_setfloat(tc, 1, 1, 5);
+}
+
+void mr_heater_menu_pid_time(float seconds)
+{
+	srd_set(0, SRD_E | SRD_F);
+	srd_setfloat(seconds, 1, 1, 5);
+}
+
+void mr_heater_menu_pid_dob_threshold(float threshold)
+{
+	srd_set(0, SRD_E | SRD_F);
+	srd_setfloat(threshold, 1, 1, 5);
 }
 
 void mr_stirrer_menu_dc(uint8_t dutycycle)
@@ -254,6 +587,26 @@ void mr_stirrer_menu_dc(uint8_t dutycycle)
 	}	
 }
 
+void mr_stirrer_menu_waveform(uint8_t waveform)
+{
+	srd_set(0, SRD_E | SRD_F);
+	switch (waveform)
+	{
+		case AGT_WAVE_CONSTANT: // "CONST"
+			srd_set(1, SRD_CC); srd_set(2, SRD_CO); srd_set(3, SRD_CN); srd_set(4, SRD_CS); srd_set(5, SRD_CT);
+			break;
+		case AGT_WAVE_BURST: // "BURST"
+			srd_set(1, SRD_CB); srd_set(2, SRD_CU); srd_set(3, SRD_CR); srd_set(4, SRD_CS); srd_set(5, SRD_CT);
+			break;
+		case AGT_WAVE_RAMP: // "RAMP"
+			srd_set(1, SRD_CR); srd_set(2, SRD_CA); srd_set(3, SRD_CN); srd_set(4, SRD_CN); srd_set(5, SRD_CP);
+			break;
+		case AGT_WAVE_SINE: // "SINE"
+			srd_set(1, SRD_CS); srd_set(2, SRD_CI); srd_set(3, SRD_CN); srd_set(4, SRD_CE);
+			break;
+	}
+}
+
 void mr_fan_menu_dc(uint8_t dutycycle)
 {
 	srd_set(0, SRD_E | SRD_F);
@@ -267,6 +620,12 @@ void mr_fan_menu_dc(uint8_t dutycycle)
 	}
 }
 
+void mr_fan_menu_rpm(float rpm)
+{
+	srd_set(0, SRD_E | SRD_F);
+	srd_setint16((int16_t)(rpm + 0.5), 1, 5);
+}
+
 void mr_tprobe_menu(uint8_t menu_index)
 {
 	switch(menu_index)
@@ -322,8 +681,119 @@ void mr_thermistor_error(ErrorCode error)
 		case EC_THERMISTOR_MAX_TEMP:
 			srd_set(0, SRD_CT); srd_set(1, SRD_CH | SRD_DOT); srd_set(2, SRD_CH); srd_set(3, SRD_CT); srd_set(4, SRD_CP);
 			break;
+		case EC_THERMISTOR_IMPLAUSIBLE:
+			srd_set(0, SRD_CT); srd_set(1, SRD_CH | SRD_DOT); srd_set(2, SRD_CI); srd_set(3, SRD_CN); srd_set(4, SRD_CN); srd_set(5, SRD_CP);
+			break;
+		case EC_DRY_HEATING:
+			srd_set(0, SRD_CD); srd_set(1, SRD_CR); srd_set(2, SRD_CY);
+			break;
+		case EC_FAN_STALL:
+			srd_set(0, SRD_CF); srd_set(1, SRD_CA | SRD_DOT); srd_set(2, SRD_CS); srd_set(3, SRD_CT); srd_set(4, SRD_CL);
+			break;
 		default:
 			srd_set(0, SRD_CE); srd_set(1, SRD_CR); srd_set(2, SRD_CR); srd_set(3, SRD_CO); srd_set(4, SRD_CR);
 			break;
 	}
-}
\ No newline at end of file
+}
+
+void mr_self_test(uint8_t step)
+{
+	// "TEST" and the running step
+	srd_set(0, SRD_CT); srd_set(1, SRD_CE); srd_set(2, SRD_CS); srd_set(3, SRD_CT);
+	srd_setint16(step + 1, 5, 1);
+}
+
+void mr_self_test_result(uint8_t result, uint8_t probe)
+{
+	// "PASS" or "FAIL" with the failure code, e.g. "FAIL 2". Adc failures show the probe after the code, e.g. "FAIL10" for probe 0.
+	if(result == 0)
+	{
+		srd_set(0, SRD_CP); srd_set(1, SRD_CA); srd_set(2, SRD_CS); srd_set(3, SRD_CS);
+		return;
+	}
+	srd_set(0, SRD_CF); srd_set(1, SRD_CA); srd_set(2, SRD_CI); srd_set(3, SRD_CL);
+	if(probe < TSENS_MAX_PROBES)
+	{
+		srd_setint16(result, 4, 1);
+		srd_setint16(probe, 5, 1);
+	}
+	else
+	{
+		srd_setint16(result, 5, 1);
+	}
+}
+
+void mr_recipe_menu(uint8_t item_index)
+{
+	switch (item_index)
+	{
+		case 0: // "--"
+			srd_set(0, SRD_MINUS); srd_set(1, SRD_MINUS);
+			break;
+		case 1: // "RUN"
+			srd_set(0, SRD_CR); srd_set(1, SRD_CU); srd_set(2, SRD_CN);
+			break;
+		default: // segment number, e.g. "SEG 3"
+			srd_set(0, SRD_CS); srd_set(1, SRD_CE); srd_set(2, SRD_CG);
+			srd_setint16(item_index - 1, 3, 3);
+			break;
+	}
+}
+
+void mr_recipe_segment_menu(uint8_t item_index)
+{
+	switch (item_index)
+	{
+		case 0: // "--"
+			srd_set(0, SRD_MINUS); srd_set(1, SRD_MINUS);
+			break;
+		case 1: // "TYPE"
+			srd_set(0, SRD_CT); srd_set(1, SRD_CY); srd_set(2, SRD_CP); srd_set(3, SRD_CE);
+			break;
+		case 2: // "VAL"
+			srd_set(0, SRD_CV); srd_set(1, SRD_CA); srd_set(2, SRD_CL);
+			break;
+		case 3: // "ARG"
+			srd_set(0, SRD_CA); srd_set(1, SRD_CR); srd_set(2, SRD_CG);
+			break;
+	}
+}
+
+void mr_recipe_segment_type(uint8_t type)
+{
+	switch (type)
+	{
+		case RCP_SEG_END: // "END"
+			srd_set(0, SRD_CE); srd_set(1, SRD_CN); srd_set(2, SRD_CD);
+			break;
+		case RCP_SEG_RAMP: // "RAMP"
+			srd_set(0, SRD_CR); srd_set(1, SRD_CA); srd_set(2, SRD_CN); srd_set(3, SRD_CN); srd_set(4, SRD_CP);
+			break;
+		case RCP_SEG_HOLD: // "HOLD"
+			srd_set(0, SRD_CH); srd_set(1, SRD_CO); srd_set(2, SRD_CL); srd_set(3, SRD_CD);
+			break;
+		case RCP_SEG_STIRRER: // "STIR"
+			srd_set(0, SRD_CS); srd_set(1, SRD_CT); srd_set(2, SRD_CI); srd_set(3, SRD_CR);
+			break;
+		case RCP_SEG_IDLE: // "IDLE"
+			srd_set(0, SRD_CI); srd_set(1, SRD_CD); srd_set(2, SRD_CL); srd_set(3, SRD_CE);
+			break;
+	}
+}
+
+void mr_recipe_segment_value(float value, uint8_t decimal_places)
+{
+	srd_set(0, SRD_E | SRD_F);
+	if(decimal_places > 0)
+		srd_setfloat(value, 1, decimal_places, 5);
+	else
+		srd_setint16((int16_t)value, 1, 5);
+}
+
+void mr_recipe_progress(uint8_t segment, uint8_t percent)
+{
+	// "R 3 45": segment number and progress of the segment in percent
+	srd_set(0, SRD_CR);
+	srd_setint16(segment + 1, 1, 2);
+	srd_setint16(percent, 3, 3);
+}
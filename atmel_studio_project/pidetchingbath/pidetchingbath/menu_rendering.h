@@ -32,10 +32,25 @@ SOFTWARE.
 void mr_main(float current_temp, uint8_t tprobe_index);
 
 void mr_main_menu(uint8_t item_index);
+void mr_stats(uint8_t page, float value);
+void mr_fault_count(uint16_t count);
+void mr_fault(ErrorCode error, uint8_t probe, uint16_t age_minutes);
+void mr_zone_menu(uint8_t item_index);
+void mr_zone_edit_menu(uint8_t item_index);
 void mr_heater_menu(uint8_t item_index);
+void mr_heater_menu_output(uint8_t item_index);
+void mr_heater_menu_eco(uint8_t item_index);
+void mr_heater_menu_eco_timeout(uint16_t minutes);
+void mr_eco_standby();
+void mr_time_to_ready(float seconds);
+void mr_heater_menu_output_mode(uint8_t mode);
 void mr_stirrer_menu(uint8_t item_index);
 void mr_fan_menu(uint8_t item_index);
 void mr_heater_menu_pid(uint8_t item_index);
+void mr_heater_menu_pid_gs(uint8_t item_index);
+void mr_heater_menu_pid_d_filter(uint8_t item_index);
+void mr_heater_menu_pid_smith(uint8_t item_index);
+void mr_heater_menu_pid_dob(uint8_t item_index);
 
 void mr_heater_menu_onoff(uint8_t onoff);
 void mr_heater_menu_target_temp(float temp);
@@ -45,15 +60,29 @@ void mr_heater_menu_pid_i(float pid_i);
 void mr_heater_menu_pid_d(float pid_d);
 void mr_heater_menu_pid_i_clamp(float pid_i_clamp);
 void mr_heater_menu_pid_offset(float offset);
-void mr_heater_menu_pid_dsmooth(float dsmooth);
+void mr_heater_menu_pid_d_filter_param(float value);
+void mr_heater_menu_pid_sp_weight(float weight);
+void mr_heater_menu_pid_sp_filter_tc(float tc);
+void mr_heater_menu_pid_time(float seconds);
+void mr_heater_menu_pid_dob_threshold(float threshold);
 
 void mr_stirrer_menu_dc(uint8_t dutycycle);
+void mr_stirrer_menu_waveform(uint8_t waveform);
 void mr_fan_menu_dc(uint8_t dutycycle);
+void mr_fan_menu_rpm(float rpm);
 
 void mr_tprobe_menu(uint8_t menu_index);
 void mr_tprobe_calib_menu(float resistance);
 void mr_tprobe_calib_menu_nc();
 
+void mr_recipe_menu(uint8_t item_index);
+void mr_recipe_segment_menu(uint8_t item_index);
+void mr_recipe_segment_type(uint8_t type);
+void mr_recipe_segment_value(float value, uint8_t decimal_places);
+void mr_recipe_progress(uint8_t segment, uint8_t percent);
+
 void mr_thermistor_error(ErrorCode error);
+void mr_self_test(uint8_t step);
+void mr_self_test_result(uint8_t result, uint8_t probe);
 
 #endif /* MENU_RENDERING_H_ */
\ No newline at end of file
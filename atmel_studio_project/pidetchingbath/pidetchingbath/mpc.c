@@ -0,0 +1,66 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+#include "mpc.h"
+#include "my_util.h"
+#include <math.h>
+
+static uint8_t mpc_cell_index(float x, float x_min, float step, uint8_t cells)
+{
+	return (uint8_t)fmax(fmin(floor((x - x_min) / step), cells - 1), 0.0);
+}
+
+static float mpc_law(const int16_t* law, float x1, float x2)
+{
+	return (int16_t)pgm_read_word(&law[0]) / MPC_TABLE_OFFSET_SCALE
+		+ ((int16_t)pgm_read_word(&law[1]) * x1 + (int16_t)pgm_read_word(&law[2]) * x2) / MPC_TABLE_GAIN_SCALE;
+}
+
+uint8_t mpc_in_range(float set_point)
+{
+	return set_point >= MPC_TABLE_SET_POINT_MIN && set_point <= MPC_SET_POINT_MAX;
+}
+
+float mpc_output(float set_point, float bath_error, float mat_deviation)
+{
+	// the outermost cells are used outside of the grid, states are clamped to the grid so the laws are not extrapolated
+	bath_error = fmax(fmin(bath_error, MPC_TABLE_BATH_MIN + MPC_TABLE_BATH_CELLS * MPC_TABLE_BATH_STEP), MPC_TABLE_BATH_MIN);
+	mat_deviation = fmax(fmin(mat_deviation, MPC_TABLE_MAT_MIN + MPC_TABLE_MAT_CELLS * MPC_TABLE_MAT_STEP), MPC_TABLE_MAT_MIN);
+	// region lookup
+	uint8_t i = mpc_cell_index(bath_error, MPC_TABLE_BATH_MIN, MPC_TABLE_BATH_STEP, MPC_TABLE_BATH_CELLS);
+	uint8_t j = mpc_cell_index(mat_deviation, MPC_TABLE_MAT_MIN, MPC_TABLE_MAT_STEP, MPC_TABLE_MAT_CELLS);
+	uint16_t cell = i * MPC_TABLE_MAT_CELLS + j;
+	// affine laws relative to the cell center
+	float x1 = bath_error - (MPC_TABLE_BATH_MIN + (i + 0.5) * MPC_TABLE_BATH_STEP);
+	float x2 = mat_deviation - (MPC_TABLE_MAT_MIN + (j + 0.5) * MPC_TABLE_MAT_STEP);
+	#if MPC_TABLE_SET_POINTS > 1
+		// linear interpolation between the tables of the neighbouring design set points
+		float s = fmax(fmin((set_point - MPC_TABLE_SET_POINT_MIN) / MPC_TABLE_SET_POINT_STEP, MPC_TABLE_SET_POINTS - 1), 0.0);
+		uint8_t k = (uint8_t)fmin(floor(s), MPC_TABLE_SET_POINTS - 2);
+		float w = s - k;
+		return (1.0 - w) * mpc_law(mpc_table[k][cell], x1, x2) + w * mpc_law(mpc_table[k + 1][cell], x1, x2);
+	#else
+		return mpc_law(mpc_table[0][cell], x1, x2);
+	#endif
+}
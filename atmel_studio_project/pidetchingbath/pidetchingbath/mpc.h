@@ -0,0 +1,44 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef MPC_H_
+#define MPC_H_
+#include <stdint.h>
+#include "mpc_table.h"
+
+// highest set point covered by the tables
+#define MPC_SET_POINT_MAX (MPC_TABLE_SET_POINT_MIN + (MPC_TABLE_SET_POINTS - 1) * MPC_TABLE_SET_POINT_STEP)
+
+// Explicit model predictive control. The constrained MPC of the bath / heater mat model is solved offline
+// (mpc_table_script/mpctable.py) and stored as one affine law per cell of a regular state grid.
+// The duty cycle range and the mat temperature limit depend on the set point, so there is one table per design
+// set point and the output is interpolated between the two neighbouring tables. The tables are only valid for
+// set points in [MPC_TABLE_SET_POINT_MIN, MPC_SET_POINT_MAX] and near the design ambient temperature of the script,
+// check mpc_in_range before using the output.
+// Returns the duty cycle deviation from the holding duty cycle.
+uint8_t mpc_in_range(float set_point);
+float mpc_output(float set_point, float bath_error, float mat_deviation);
+
+#endif /* MPC_H_ */
@@ -0,0 +1,999 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+// generated by mpc_table_script/mpctable.py, do not edit
+// ambient=20.0 bath_gain=0.5 bath_range=[-24.0, 8.0] bath_tau=1666.6666666666667 blocks=4 cells=[16, 15] horizon=24 interval=15.0 mat_gain=0.3 mat_max=140.0 mat_range=[-40.0, 110.0] mat_tau=30.0 q=1.0 r=0.002 samples=4 set_points=[30.0, 60.0, 4]
+
+#include "mpc_table.h"
+
+const int16_t mpc_table[MPC_TABLE_SET_POINTS][MPC_TABLE_BATH_CELLS * MPC_TABLE_MAT_CELLS][3] PROGMEM = {
+	{ // 30.0 degC
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20425, -1049, -159},
+		{20164, -6068, -222},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20480, 0, 0},
+		{20463, -331, -66},
+		{20237, -4659, -222},
+		{19894, -10414, -395},
+		{19351, -17446, -445},
+		{18655, -23662, -667},
+		{17807, -28736, -719},
+		{16759, -29952, -889},
+		{15648, -29952, -889},
+		{14536, -29952, -889},
+		{20311, -3251, -222},
+		{20008, -8743, -307},
+		{19498, -15568, -445},
+		{18866, -22194, -631},
+		{18041, -27589, -667},
+		{17053, -29952, -889},
+		{15941, -29952, -889},
+		{14829, -29952, -889},
+		{13718, -29952, -889},
+		{12606, -29952, -889},
+		{11494, -29952, -889},
+		{10383, -29952, -889},
+		{9271, -29952, -889},
+		{8160, -29952, -889},
+		{7048, -29952, -889},
+		{15123, -29952, -889},
+		{14011, -29952, -889},
+		{12899, -29952, -889},
+		{11788, -29952, -889},
+		{10676, -29952, -889},
+		{9565, -29952, -889},
+		{8453, -29952, -889},
+		{7341, -29952, -889},
+		{6230, -29952, -889},
+		{5118, -29952, -889},
+		{4006, -29952, -889},
+		{2895, -29952, -889},
+		{1783, -29952, -889},
+		{672, -29952, -889},
+		{-440, -29952, -889},
+		{7635, -29952, -889},
+		{6523, -29952, -889},
+		{5411, -29952, -889},
+		{4300, -29952, -889},
+		{3188, -29952, -889},
+		{2077, -29952, -889},
+		{965, -29952, -889},
+		{-147, -29952, -889},
+		{-1258, -29952, -889},
+		{-2328, -29146, -760},
+		{-3189, -24338, -667},
+		{-3920, -18344, -446},
+		{-4472, -11259, -429},
+		{-4842, -5335, -222},
+		{-5085, -667, -111},
+		{147, -29952, -889},
+		{-965, -29952, -889},
+		{-2065, -29734, -846},
+		{-2969, -25746, -667},
+		{-3754, -20096, -519},
+		{-4330, -13111, -445},
+		{-4769, -6744, -222},
+		{-5039, -1556, -193},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-4973, -2816, -222},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0},
+		{-5120, 0, 0}
+	},
+	{ // 40.0 degC
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15278, -1570, -194},
+		{15008, -6762, -222},
+		{14568, -13136, -445},
+		{13991, -20117, -520},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15360, 0, 0},
+		{15325, -676, -112},
+		{15081, -5354, -222},
+		{14711, -11283, -430},
+		{14158, -18368, -447},
+		{13426, -24357, -667},
+		{12565, -29155, -761},
+		{11494, -29952, -889},
+		{10383, -29952, -889},
+		{9271, -29952, -889},
+		{8160, -29952, -889},
+		{7048, -29952, -889},
+		{14305, -16495, -445},
+		{13646, -22947, -666},
+		{12808, -28201, -684},
+		{11788, -29952, -889},
+		{10676, -29952, -889},
+		{9565, -29952, -889},
+		{8453, -29952, -889},
+		{7341, -29952, -889},
+		{6230, -29952, -889},
+		{5118, -29952, -889},
+		{4006, -29952, -889},
+		{2895, -29952, -889},
+		{1783, -29952, -889},
+		{672, -29952, -889},
+		{-440, -29952, -889},
+		{7635, -29952, -889},
+		{6523, -29952, -889},
+		{5411, -29952, -889},
+		{4300, -29952, -889},
+		{3188, -29952, -889},
+		{2077, -29952, -889},
+		{965, -29952, -889},
+		{-147, -29952, -889},
+		{-1258, -29952, -889},
+		{-2370, -29952, -889},
+		{-3482, -29952, -889},
+		{-4593, -29952, -889},
+		{-5705, -29952, -889},
+		{-6816, -29952, -889},
+		{-7804, -27571, -667},
+		{147, -29952, -889},
+		{-965, -29952, -889},
+		{-2077, -29952, -889},
+		{-3188, -29952, -889},
+		{-4300, -29952, -889},
+		{-5411, -29952, -889},
+		{-6523, -29952, -889},
+		{-7571, -28722, -718},
+		{-8418, -23643, -667},
+		{-9113, -17421, -445},
+		{-9656, -10391, -394},
+		{-9998, -4641, -222},
+		{-10223, -326, -65},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-7318, -29503, -807},
+		{-8198, -25052, -667},
+		{-8957, -19236, -482},
+		{-9522, -12184, -445},
+		{-9925, -6049, -222},
+		{-10186, -1035, -158},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0},
+		{-10240, 0, 0}
+	},
+	{ // 50.0 degC
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10130, -2121, -222},
+		{9845, -7497, -246},
+		{9375, -14062, -445},
+		{8781, -20928, -566},
+		{7978, -26460, -667},
+		{7046, -29913, -881},
+		{10240, 0, 0},
+		{10240, 0, 0},
+		{10186, -1035, -158},
+		{9925, -6049, -222},
+		{9522, -12184, -445},
+		{8957, -19236, -482},
+		{8198, -25052, -667},
+		{7318, -29503, -807},
+		{6230, -29952, -889},
+		{5118, -29952, -889},
+		{4006, -29952, -889},
+		{2895, -29952, -889},
+		{1783, -29952, -889},
+		{672, -29952, -889},
+		{-440, -29952, -889},
+		{7571, -28722, -718},
+		{6523, -29952, -889},
+		{5411, -29952, -889},
+		{4300, -29952, -889},
+		{3188, -29952, -889},
+		{2077, -29952, -889},
+		{965, -29952, -889},
+		{-147, -29952, -889},
+		{-1258, -29952, -889},
+		{-2370, -29952, -889},
+		{-3482, -29952, -889},
+		{-4593, -29952, -889},
+		{-5705, -29952, -889},
+		{-6816, -29952, -889},
+		{-7928, -29952, -889},
+		{147, -29952, -889},
+		{-965, -29952, -889},
+		{-2077, -29952, -889},
+		{-3188, -29952, -889},
+		{-4300, -29952, -889},
+		{-5411, -29952, -889},
+		{-6523, -29952, -889},
+		{-7635, -29952, -889},
+		{-8746, -29952, -889},
+		{-9858, -29952, -889},
+		{-10970, -29952, -889},
+		{-12081, -29952, -889},
+		{-13033, -26876, -667},
+		{-13847, -21413, -594},
+		{-14452, -14617, -445},
+		{-7341, -29952, -889},
+		{-8453, -29952, -889},
+		{-9565, -29952, -889},
+		{-10676, -29952, -889},
+		{-11788, -29952, -889},
+		{-12808, -28201, -684},
+		{-13646, -22947, -666},
+		{-14305, -16495, -445},
+		{-14834, -9553, -353},
+		{-15154, -3946, -222},
+		{-15352, -153, -31},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-14158, -18368, -447},
+		{-14711, -11283, -430},
+		{-15081, -5354, -222},
+		{-15325, -676, -112},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0},
+		{-15360, 0, 0}
+	},
+	{ // 60.0 degC
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{1646, -5054, -8668},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{360, -5478, -10201},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{-1233, -6739, -10553},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5093, -511, -103},
+		{-2918, -6739, -10553},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{4751, -1685, -1418},
+		{-4602, -6739, -10553},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{4294, -2310, -3081},
+		{-6287, -6739, -10553},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{3521, -3369, -5149},
+		{-7972, -6739, -10553},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{2634, -4109, -7248},
+		{-9656, -6739, -10553},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{1431, -5054, -8943},
+		{-11341, -6739, -10553},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{114, -5908, -10355},
+		{-13026, -6739, -10553},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{5120, 0, 0},
+		{4973, -2816, -222},
+		{4680, -8249, -281},
+		{4183, -14989, -445},
+		{3568, -21723, -610},
+		{2749, -27155, -667},
+		{1783, -29952, -889},
+		{-2200, -14355, -8184},
+		{-14710, -6739, -10553},
+		{5039, -1556, -193},
+		{4769, -6744, -222},
+		{4330, -13111, -445},
+		{3754, -20096, -519},
+		{2969, -25746, -667},
+		{2065, -29734, -846},
+		{965, -29952, -889},
+		{-147, -29952, -889},
+		{-1258, -29952, -889},
+		{-2370, -29952, -889},
+		{-3482, -29952, -889},
+		{-4593, -29952, -889},
+		{-5705, -29952, -889},
+		{-7129, -25572, -2078},
+		{-16395, -6739, -10553},
+		{147, -29952, -889},
+		{-965, -29952, -889},
+		{-2077, -29952, -889},
+		{-3188, -29952, -889},
+		{-4300, -29952, -889},
+		{-5411, -29952, -889},
+		{-6523, -29952, -889},
+		{-7635, -29952, -889},
+		{-8746, -29952, -889},
+		{-9858, -29952, -889},
+		{-10970, -29952, -889},
+		{-12081, -29952, -889},
+		{-13193, -29952, -889},
+		{-14304, -29952, -889},
+		{-18630, -13397, -8606},
+		{-7341, -29952, -889},
+		{-8453, -29952, -889},
+		{-9565, -29952, -889},
+		{-10676, -29952, -889},
+		{-11788, -29952, -889},
+		{-12899, -29952, -889},
+		{-14011, -29952, -889},
+		{-15123, -29952, -889},
+		{-16234, -29952, -889},
+		{-17340, -29843, -868},
+		{-18261, -26181, -667},
+		{-19057, -20603, -548},
+		{-19644, -13691, -445},
+		{-20104, -7195, -232},
+		{-21689, -4958, -4595},
+		{-14829, -29952, -889},
+		{-15941, -29952, -889},
+		{-17053, -29952, -889},
+		{-18041, -27589, -667},
+		{-18866, -22194, -631},
+		{-19498, -15568, -445},
+		{-20008, -8743, -307},
+		{-20311, -3251, -222},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-22614, -3369, -6517},
+		{-20237, -4659, -222},
+		{-20463, -331, -66},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-20480, 0, 0},
+		{-23707, -5054, -8352}
+	}
+};
@@ -0,0 +1,49 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */
+
+// generated by mpc_table_script/mpctable.py, do not edit
+// ambient=20.0 bath_gain=0.5 bath_range=[-24.0, 8.0] bath_tau=1666.6666666666667 blocks=4 cells=[16, 15] horizon=24 interval=15.0 mat_gain=0.3 mat_max=140.0 mat_range=[-40.0, 110.0] mat_tau=30.0 q=1.0 r=0.002 samples=4 set_points=[30.0, 60.0, 4]
+
+
+#ifndef MPC_TABLE_H_
+#define MPC_TABLE_H_
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+#define MPC_TABLE_SET_POINTS 4
+#define MPC_TABLE_SET_POINT_MIN 30.000
+#define MPC_TABLE_SET_POINT_STEP 10.000
+#define MPC_TABLE_BATH_CELLS 16
+#define MPC_TABLE_MAT_CELLS 15
+#define MPC_TABLE_BATH_MIN -24.000
+#define MPC_TABLE_BATH_STEP 2.000
+#define MPC_TABLE_MAT_MIN -40.000
+#define MPC_TABLE_MAT_STEP 10.000
+#define MPC_TABLE_OFFSET_SCALE 256.0
+#define MPC_TABLE_GAIN_SCALE 2048.0
+
+// per set point and cell (bath major): offset, bath error gain, mat deviation gain. Relative to the cell center.
+extern const int16_t mpc_table[MPC_TABLE_SET_POINTS][MPC_TABLE_BATH_CELLS * MPC_TABLE_MAT_CELLS][3] PROGMEM;
+
+#endif /* MPC_TABLE_H_ */
@@ -0,0 +1,113 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+#include "recipe.h"
+#include "my_util.h"
+
+static void rcp_next_segment(rcp_state_t* state)
+{
+	state->segment_time = 0.0;
+	state->segment_start_set_point = state->set_point;
+	if(++state->segment >= RCP_MAX_SEGMENTS)
+		state->running = FALSE;
+}
+
+void rcp_start(rcp_state_t* state, float set_point)
+{
+	state->running = TRUE;
+	state->segment = 0;
+	state->segment_time = 0.0;
+	state->segment_start_set_point = set_point;
+	state->set_point = set_point;
+	state->stirrer_duty_cycle = 0;
+}
+
+void rcp_stop(rcp_state_t* state)
+{
+	state->running = FALSE;
+}
+
+uint8_t rcp_update(rcp_state_t* state, const rcp_segment_t* segments, float process_value, float dt)
+{
+	uint8_t actions = 0;
+	if(!state->running)
+		return actions;
+	state->segment_time += dt;
+	// segments without duration are processed in the same update
+	while(state->running)
+	{
+		const rcp_segment_t* seg = &segments[state->segment];
+		switch(seg->type)
+		{
+			case RCP_SEG_RAMP:
+			{
+				float target = seg->value * 0.1;
+				float max_step = seg->arg * (0.1 / 60.0) * dt;
+				// rate limited set point, arg = 0 is a step
+				if(seg->arg == 0 || fabs(target - state->set_point) <= max_step)
+					state->set_point = target;
+				else
+					state->set_point += (target > state->set_point) ? max_step : -max_step;
+				actions |= RCP_ACTION_SET_POINT;
+				// the next segment starts when the bath is there
+				if(state->set_point != target || fabs(process_value - target) > RCP_RAMP_SETTLE_BAND)
+					return actions;
+				break;
+			}
+			case RCP_SEG_HOLD:
+				if(state->segment_time < seg->value)
+					return actions;
+				break;
+			case RCP_SEG_STIRRER:
+				state->stirrer_duty_cycle = seg->arg;
+				actions |= RCP_ACTION_STIRRER;
+				break;
+			case RCP_SEG_IDLE:
+				state->running = FALSE;
+				return actions | RCP_ACTION_IDLE;
+			default: // RCP_SEG_END
+				state->running = FALSE;
+				return actions;
+		}
+		rcp_next_segment(state);
+	}
+	return actions;
+}
+
+uint8_t rcp_progress(rcp_state_t* state, const rcp_segment_t* segments)
+{
+	// progress of the current segment in percent
+	const rcp_segment_t* seg = &segments[state->segment];
+	float progress = 0.0;
+	if(seg->type == RCP_SEG_RAMP)
+	{
+		float span = seg->value * 0.1 - state->segment_start_set_point;
+		progress = fabs(span) > 0.0 ? (state->set_point - state->segment_start_set_point) / span : 1.0;
+	}
+	else if(seg->type == RCP_SEG_HOLD && seg->value > 0)
+	{
+		progress = state->segment_time / seg->value;
+	}
+	return (uint8_t)(fmax(fmin(progress, 1.0), 0.0) * 100.0);
+}
@@ -0,0 +1,67 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef RECIPE_H_
+#define RECIPE_H_
+#include <stdint.h>
+#include "config.h"
+
+// segment types
+#define RCP_SEG_END 0		// recipe ends, heater keeps the last set point
+#define RCP_SEG_RAMP 1		// ramp the set point to value (0.1 degC) with arg (0.1 K/min, 0 = step) and wait until the bath is there
+#define RCP_SEG_HOLD 2		// hold the set point for value seconds
+#define RCP_SEG_STIRRER 3	// set stirrer duty cycle to arg
+#define RCP_SEG_IDLE 4		// heater and stirrer off, recipe ends
+#define RCP_NUM_SEG_TYPES 5
+
+// actions requested by rcp_update
+#define RCP_ACTION_SET_POINT (1 << 0)
+#define RCP_ACTION_STIRRER (1 << 1)
+#define RCP_ACTION_IDLE (1 << 2)
+
+// one recipe step, 4 bytes in eeprom
+typedef struct
+{
+	uint8_t type;
+	uint8_t arg;
+	uint16_t value;
+} rcp_segment_t;
+
+typedef struct
+{
+	uint8_t running;
+	uint8_t segment;				// index of the current segment
+	float segment_time;				// seconds since the start of the current segment
+	float segment_start_set_point;	// set point at the start of the current segment
+	float set_point;				// ramped set point
+	uint8_t stirrer_duty_cycle;		// requested stirrer duty cycle
+} rcp_state_t;
+
+void rcp_start(rcp_state_t* state, float set_point);
+void rcp_stop(rcp_state_t* state);
+uint8_t rcp_update(rcp_state_t* state, const rcp_segment_t* segments, float process_value, float dt);
+uint8_t rcp_progress(rcp_state_t* state, const rcp_segment_t* segments);
+
+#endif /* RECIPE_H_ */
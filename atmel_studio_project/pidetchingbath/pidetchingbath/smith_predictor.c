@@ -0,0 +1,85 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+#include "smith_predictor.h"
+#include "my_util.h"
+
+#if (HEATER_SMITH_DELAY_SLOTS & (HEATER_SMITH_DELAY_SLOTS - 1)) != 0
+	#error "SMITH PREDICTOR: HEATER_SMITH_DELAY_SLOTS has to be a power of two."
+#endif
+
+#define SMITH_DELAY_MASK (HEATER_SMITH_DELAY_SLOTS - 1)
+// duty cycles are stored with 0.5% resolution
+#define SMITH_DUTY_SCALE 2.0
+
+void smith_init(smith_state_t* state, float gain, float tau, float dead_time)
+{
+	tm_init(&state->model, gain, tau, PID_DELTA_T);
+	tm_init(&state->delayed_model, gain, tau, PID_DELTA_T);
+	for(uint8_t i = 0; i < HEATER_SMITH_DELAY_SLOTS; ++i)
+		state->delay_line[i] = 0;
+	state->delay_head = 0;
+	state->slot_ticks = 0;
+	state->slot_duty_sum = 0.0;
+	state->delayed_duty = 0.0;
+	smith_set_params(state, gain, tau, dead_time);
+}
+
+void smith_set_params(smith_state_t* state, float gain, float tau, float dead_time)
+{
+	tm_set_params(&state->model, gain, tau, PID_DELTA_T);
+	tm_set_params(&state->delayed_model, gain, tau, PID_DELTA_T);
+	state->delay_slots = (uint8_t)fmax(fmin(dead_time / HEATER_SMITH_SLOT_TIME + 0.5, HEATER_SMITH_DELAY_SLOTS), 0.0);
+}
+
+float smith_correct(smith_state_t* state, float process_value)
+{
+	// predicted process value without dead time
+	return process_value + state->model.output - state->delayed_model.output;
+}
+
+float smith_get_delayed_duty(smith_state_t* state)
+{
+	return state->delayed_duty;
+}
+
+void smith_step(smith_state_t* state, float duty)
+{
+	// delay free model
+	tm_step(&state->model, duty);
+	// delayed model, input is taken from the delay line
+	state->delayed_duty = duty;
+	if(state->delay_slots > 0)
+		state->delayed_duty = state->delay_line[(state->delay_head - state->delay_slots) & SMITH_DELAY_MASK] / SMITH_DUTY_SCALE;
+	tm_step(&state->delayed_model, state->delayed_duty);
+	// average the duty cycle over one slot and push it into the delay line
+	state->slot_duty_sum += duty;
+	if(++state->slot_ticks >= HEATER_SMITH_SLOT_TICKS)
+	{
+		state->delay_line[state->delay_head] = (uint8_t)(fmax(fmin(state->slot_duty_sum / state->slot_ticks, HEATER_CONTROL_MAX), HEATER_CONTROL_MIN) * SMITH_DUTY_SCALE + 0.5);
+		state->delay_head = (state->delay_head + 1) & SMITH_DELAY_MASK;
+		state->slot_ticks = 0;
+		state->slot_duty_sum = 0.0;
+	}
+}
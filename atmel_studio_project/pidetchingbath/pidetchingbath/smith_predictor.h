@@ -0,0 +1,53 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef SMITH_PREDICTOR_H_
+#define SMITH_PREDICTOR_H_
+#include <stdint.h>
+#include "config.h"
+#include "thermal_model.h"
+
+// Smith predictor for a first order plus dead time model.
+// The controller sees the process value corrected by the difference between the delay free and the delayed model,
+// so it can be tuned for the delay free plant.
+typedef struct
+{
+	tm_state_t model;								// model driven by the current duty cycle
+	tm_state_t delayed_model;						// model driven by the duty cycle of one dead time ago
+	uint8_t delay_line[HEATER_SMITH_DELAY_SLOTS];	// past duty cycles, one averaged value per slot
+	uint8_t delay_head;								// next slot to write
+	uint8_t delay_slots;							// dead time in slots
+	uint8_t slot_ticks;								// control steps accumulated in the current slot
+	float slot_duty_sum;							// sum of the duty cycles of the current slot
+	float delayed_duty;								// duty cycle of one dead time ago, as seen by the probe now
+} smith_state_t;
+
+void smith_init(smith_state_t* state, float gain, float tau, float dead_time);
+void smith_set_params(smith_state_t* state, float gain, float tau, float dead_time);
+float smith_correct(smith_state_t* state, float process_value);
+float smith_get_delayed_duty(smith_state_t* state);
+void smith_step(smith_state_t* state, float duty);
+
+#endif /* SMITH_PREDICTOR_H_ */
@@ -23,8 +23,11 @@ SOFTWARE.
  */ 
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
 #include "config.h"
 #include "stirrer_fan.h"
+#include "app_timer.h"
 #include "my_util.h"
 
 /*
@@ -81,6 +84,11 @@ SOFTWARE.
 #define STIRRER_FAN_PWM_WGM_BITS_A 0x00
 #define STIRRER_FAN_PWM_WGM_BITS_B (1 << WGM13) // phase and frequency correct pwm mode. top set by ICR1
 
+#ifdef FAN_TACH
+static void fan_tach_init();
+static void fan_tach_shutdown();
+#endif
+
 void stirrer_fan_init()
 {
 	TIMSK1 = 0x00;
@@ -140,6 +148,10 @@ void stirrer_fan_init()
 	
 	// start timer
 	TCCR1B |= STIRRER_FAN_PWM_PRESCALE_BITS;
+	
+	#ifdef FAN_TACH
+	fan_tach_init();
+	#endif
 }
 
 void stirrer_fan_shutdown()
@@ -162,6 +174,10 @@ void stirrer_fan_shutdown()
 	// fan
 	OC1B_DDR &= ~(1 << OC1B_BIT);
 	OC1B_PORT &= ~(1 << OC1B_BIT);
+	
+	#ifdef FAN_TACH
+	fan_tach_shutdown();
+	#endif
 }
 
 void stirrer_set_duty_cycle(uint8_t dc)
@@ -202,4 +218,50 @@ void fan_off()
 	// disable fan waveform output
 	TCCR1A &= ~FAN_PWM_COMB_BITS;
 	TCNT1 = 0x0000;
-}
\ No newline at end of file
+}
+
+#ifdef FAN_TACH
+// Timer1 is the pwm time base with ICR1 as TOP, so input capture is not available. The tach signal
+// is read with a pin change interrupt and time stamped with the app timer (100us resolution).
+static volatile uint16_t fan_tach_pulses;
+static volatile uint32_t fan_tach_last_pulse_cycles;
+
+static void fan_tach_init()
+{
+	fan_tach_pulses = 0;
+	fan_tach_last_pulse_cycles = 0;
+	// open collector output of the fan, input with pull-up
+	FAN_TACH_DDR &= ~(1 << FAN_TACH_BIT);
+	FAN_TACH_PORT |= (1 << FAN_TACH_BIT);
+	// enable pin change interrupt
+	FAN_TACH_PCMSK |= (1 << FAN_TACH_PCINT);
+	PCICR |= (1 << FAN_TACH_PCIE);
+}
+
+static void fan_tach_shutdown()
+{
+	FAN_TACH_PCMSK &= ~(1 << FAN_TACH_PCINT);
+	PCICR &= ~(1 << FAN_TACH_PCIE);
+	FAN_TACH_PORT &= ~(1 << FAN_TACH_BIT);
+}
+
+void fan_tach_read(uint16_t* pulses, uint32_t* last_pulse_cycles)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		*pulses = fan_tach_pulses;
+		*last_pulse_cycles = fan_tach_last_pulse_cycles;
+	}
+}
+
+// ------------------------------ ISR ------------------------------------
+ISR(FAN_TACH_vect)
+{
+	// count falling edges only
+	if(!(FAN_TACH_PIN & (1 << FAN_TACH_BIT)))
+	{
+		++fan_tach_pulses;
+		fan_tach_last_pulse_cycles = (uint32_t)appt_get_current_cycles();
+	}
+}
+#endif
@@ -26,6 +26,7 @@ SOFTWARE.
 #ifndef STIRRER_FAN_H_
 #define STIRRER_FAN_H_
 #include <stdint.h>
+#include "config.h"
 
 void stirrer_fan_init();
 void stirrer_fan_shutdown();
@@ -38,4 +39,9 @@ void fan_set_duty_cycle(uint8_t dc);
 void fan_on();
 void fan_off();
 
+#ifdef FAN_TACH
+// number of tach pulses and app timer cycles at the last pulse
+void fan_tach_read(uint16_t* pulses, uint32_t* last_pulse_cycles);
+#endif
+
 #endif /* STIRRER_H_ */
\ No newline at end of file
@@ -86,6 +86,13 @@ SOFTWARE.
 #define TSENS_ADC_PROBE2_MUX_BITS (1 << MUX1)
 #define TSENS_ADC_PROBE3_MUX_BITS ((1 << MUX0) | (1 << MUX1))
 
+#ifdef HEATER_VSENSE
+	#if HEATER_VSENSE_CHANNEL < 4 || HEATER_VSENSE_CHANNEL > 7
+		#error "TSENS error: HEATER_VSENSE_CHANNEL must be one of the unused channels 4 .. 7."
+	#endif
+	#define TSENS_ADC_VSENSE_MUX_BITS (HEATER_VSENSE_CHANNEL & ((1 << MUX2) | (1 << MUX1) | (1 << MUX0)))
+#endif
+
 void tsens_init()
 {
 	// initialize adc
@@ -302,3 +309,59 @@ float tsens_measure_probe3_temp(ErrorCode* ec)
 	return (1.0 / (TSENS_PROBE_3_A0 + TSENS_PROBE_3_A1 * logR + TSENS_PROBE_3_A2 * logR * logR * logR)) - 273.15;
 }
 #endif
+
+#ifdef HEATER_VSENSE
+float tsens_measure_supply_voltage()
+{
+	// set channel, digital input of the channel stays disabled
+	ADMUX &= ~TSENS_ADC_MUX_MASK;
+	ADMUX |= TSENS_ADC_VSENSE_MUX_BITS;
+	uint16_t temp = 0;
+	for(uint8_t i = 0; i < TSENS_NUM_MEASUREMENTS; ++i)
+	{
+		ADCSRA |= (1 << ADSC);
+		while(ADCSRA & (1 << ADSC)) {};
+		temp += ADCW;
+	}
+	return ((float)temp / (TSENS_NUM_MEASUREMENTS * 1024)) * UVCC * HEATER_VSENSE_DIVIDER;
+}
+#endif
+
+uint16_t tsens_measure_raw_spread(uint16_t (*measure_raw)(ErrorCode*), uint8_t samples, ErrorCode* ec)
+{
+	uint16_t min = 0xFFFF;
+	uint16_t max = 0;
+	for(uint8_t i = 0; i < samples; ++i)
+	{
+		uint16_t raw = (*measure_raw)(ec);
+		if(*ec)
+			return 0;
+		if(raw < min)
+			min = raw;
+		if(raw > max)
+			max = raw;
+	}
+	return max - min;
+}
+
+void tsens_plausibility_reset(tsens_plausibility_t* state, float temp)
+{
+	state->last_temp = temp;
+	state->faults = 0;
+}
+
+float tsens_check_plausibility(tsens_plausibility_t* state, float temp, float max_rate, float dt, ErrorCode* ec)
+{
+	*ec = EC_SUCCESS;
+	// the allowed change grows with the time since the last accepted sample
+	float max_change = max_rate * dt * (state->faults + 1) + TSENS_PLAUSIBILITY_NOISE;
+	if(fabs(temp - state->last_temp) <= max_change)
+	{
+		state->last_temp = temp;
+		state->faults = 0;
+		return temp;
+	}
+	if(++state->faults >= TSENS_PLAUSIBILITY_MAX_FAULTS)
+		*ec = EC_THERMISTOR_IMPLAUSIBLE;
+	return state->last_temp;
+}
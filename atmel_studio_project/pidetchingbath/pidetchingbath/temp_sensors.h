@@ -56,4 +56,23 @@ void tsens_stop_adc();
 	float tsens_measure3_resistance(ErrorCode* ec);
 #endif
 
+#ifdef HEATER_VSENSE
+	float tsens_measure_supply_voltage();
+#endif
+
+// max - min of samples raw readings with one of the tsens_measureN_raw functions, ADC noise check of the self-test
+uint16_t tsens_measure_raw_spread(uint16_t (*measure_raw)(ErrorCode*), uint8_t samples, ErrorCode* ec);
+
+// rate of change plausibility filter of one probe
+typedef struct
+{
+	float last_temp;	// last accepted temperature
+	uint8_t faults;		// consecutive rejected samples
+} tsens_plausibility_t;
+
+void tsens_plausibility_reset(tsens_plausibility_t* state, float temp);
+// returns temp if it is reachable from the last accepted temperature with max_rate in K/s within dt, else the last accepted temperature.
+// Sets ec to EC_THERMISTOR_IMPLAUSIBLE after TSENS_PLAUSIBILITY_MAX_FAULTS consecutive rejected samples.
+float tsens_check_plausibility(tsens_plausibility_t* state, float temp, float max_rate, float dt, ErrorCode* ec);
+
 #endif /* TEMP_SENSORS_H_ */
\ No newline at end of file
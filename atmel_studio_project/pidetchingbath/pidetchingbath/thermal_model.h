@@ -0,0 +1,44 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef THERMAL_MODEL_H_
+#define THERMAL_MODEL_H_
+#include <stdint.h>
+
+// first order thermal model, discretized with time step dt:
+// temperature rise above ambient approaches gain * duty cycle with time constant tau
+typedef struct
+{
+	float gain;		// steady state temperature rise per percent duty cycle
+	float alpha;	// exp(-dt / tau)
+	float output;	// modelled temperature rise above ambient
+} tm_state_t;
+
+void tm_init(tm_state_t* state, float gain, float tau, float dt);
+void tm_set_params(tm_state_t* state, float gain, float tau, float dt);
+float tm_step(tm_state_t* state, float duty);
+void tm_reset(tm_state_t* state, float output);
+
+#endif /* THERMAL_MODEL_H_ */
@@ -0,0 +1,94 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#include "tr_supervisor.h"
+#include "my_util.h"
+
+void trs_init(trs_state_t* state, float gain, float tau)
+{
+	tm_init(&state->model, gain, tau, HEATER_TRS_INTERVAL);
+	trs_reset(state);
+}
+
+void trs_set_params(trs_state_t* state, float gain, float tau)
+{
+	tm_set_params(&state->model, gain, tau, HEATER_TRS_INTERVAL);
+}
+
+static void trs_start_window(trs_state_t* state, float process_value, float ambient_temp)
+{
+	tm_reset(&state->model, process_value - ambient_temp);
+	state->start_temp = process_value;
+	state->predicted_temp = process_value;
+	state->intervals = 0;
+	state->active = TRUE;
+}
+
+ErrorCode trs_step(trs_state_t* state, float process_value, float ambient_temp, float delayed_duty, float disturbance)
+{
+	// the model is stepped with the average duty cycle of one interval, reduced by estimated heat sinks
+	state->duty_sum += fmax(delayed_duty + fmax(fmin(disturbance, 0.0), -HEATER_TRS_MAX_DISTURBANCE), 0.0);
+	if(++state->ticks < HEATER_TRS_TICKS)
+		return EC_SUCCESS;
+	float duty = state->duty_sum / state->ticks;
+	state->duty_sum = 0.0;
+	state->ticks = 0;
+	
+	if(!state->active)
+	{
+		trs_start_window(state, process_value, ambient_temp);
+		return EC_SUCCESS;
+	}
+	state->predicted_temp = tm_step(&state->model, duty) + ambient_temp;
+	if(++state->intervals < HEATER_TRS_WINDOW_INTERVALS)
+		return EC_SUCCESS;
+	
+	// the window is only judged if the applied energy should have heated the probe noticeably
+	float expected_rise = state->predicted_temp - state->start_temp;
+	float measured_rise = process_value - state->start_temp;
+	if(expected_rise >= HEATER_TRS_MIN_EXPECTED_RISE)
+	{
+		if(measured_rise < HEATER_TRS_MIN_RESPONSE * expected_rise)
+			++state->faults;
+		else
+			state->faults = 0;
+	}
+	trs_start_window(state, process_value, ambient_temp);
+	
+	if(state->faults >= HEATER_TRS_FAULT_WINDOWS)
+		return EC_THERMISTOR_NOT_RESPONDING;
+	return EC_SUCCESS;
+}
+
+void trs_reset(trs_state_t* state)
+{
+	state->duty_sum = 0.0;
+	state->ticks = 0;
+	state->start_temp = 0.0;
+	state->predicted_temp = 0.0;
+	state->intervals = 0;
+	state->faults = 0;
+	state->active = FALSE;
+}
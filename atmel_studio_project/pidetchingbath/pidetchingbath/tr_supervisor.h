@@ -0,0 +1,56 @@
+/*
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+ */ 
+
+
+#ifndef TR_SUPERVISOR_H_
+#define TR_SUPERVISOR_H_
+#include <stdint.h>
+#include "config.h"
+#include "thermal_model.h"
+
+// Model based thermal runaway supervisor. Over every window of HEATER_TRS_WINDOW seconds, the plant model predicts the
+// temperature rise of the controlling probe for the applied duty cycle, starting from the measured temperature.
+// If the model expects a clear rise and the probe delivers less than HEATER_TRS_MIN_RESPONSE of it in
+// HEATER_TRS_FAULT_WINDOWS consecutive windows, the probe is detached or the heater failed. Heat sinks estimated by the
+// disturbance observer (cold load, fresh etchant) lower the expected rise, limited to HEATER_TRS_MAX_DISTURBANCE so a
+// detached probe can't explain itself away.
+typedef struct
+{
+	tm_state_t model;		// plant model with the supervisor interval as time step
+	float duty_sum;			// delayed duty cycles summed over the current interval
+	uint8_t ticks;			// control steps in the current interval
+	float start_temp;		// measured temperature at the beginning of the window
+	float predicted_temp;	// model temperature at the end of the last interval
+	uint8_t intervals;		// intervals in the current window
+	uint8_t faults;			// consecutive windows with too little response
+	uint8_t active;			// a window is running
+} trs_state_t;
+
+void trs_init(trs_state_t* state, float gain, float tau);
+void trs_set_params(trs_state_t* state, float gain, float tau);
+// called every control step while the heater is on. disturbance is the observer estimate in % duty cycle.
+ErrorCode trs_step(trs_state_t* state, float process_value, float ambient_temp, float delayed_duty, float disturbance);
+void trs_reset(trs_state_t* state);
+
+#endif /* TR_SUPERVISOR_H_ */
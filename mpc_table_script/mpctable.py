@@ -0,0 +1,290 @@
+"""
+MIT License
+
+Copyright (c) 2020 Fabian Friederichs
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+"""
+
+# Generates the explicit MPC region table (mpc_table.h / mpc_table.c) of the firmware.
+#
+# Plant: two node thermal model of heater mat and bath in deviation coordinates around a design set point
+#   x1 = bath temperature - set point (dead time free, the firmware uses the smith predictor output)
+#   x2 = mat temperature - steady state mat temperature at the set point
+#   u  = duty cycle - steady state duty cycle (the firmware adds the heat loss feedforward)
+# The constrained MPC (duty cycle range and mat temperature limit) is solved offline on a regular grid.
+# One affine law u = k0 + k1 * x1 + k2 * x2 is fitted per grid cell, so the firmware only needs an
+# index calculation and one affine evaluation.
+#
+# The duty cycle range and the mat limit in deviation coordinates depend on the set point, so one table is
+# generated per set point of an evenly spaced range. The firmware interpolates between the two neighbouring
+# tables and only uses the mpc for targets inside the range. The design ambient temperature is fixed.
+#
+# The plant model defaults are read from the firmware's config.h, so the tables match the model of the smith
+# predictor, the mat gradient of the dry heating detection and the heater mat limit. Regenerate the tables after changing them there.
+#
+# Only the python standard library is used.
+
+import argparse
+import math
+import os
+import re
+
+firmware_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "atmel_studio_project", "pidetchingbath", "pidetchingbath")
+
+# ----------------------------------------- config.h --------------------------------------------
+config_defines = {}
+with open(os.path.join(firmware_dir, "config.h")) as f:
+    for line in f:
+        m = re.match(r"\s*#define\s+(\w+)\s+(.+)", line.split("//")[0])
+        if m:
+            config_defines[m.group(1)] = m.group(2).strip()
+
+def config_value(name):
+    # numeric value of a define, other defines in its expression are resolved recursively
+    expr = re.sub(r"[A-Za-z_]\w*", lambda m: "(%r)" % config_value(m.group(0)), config_defines[name])
+    return float(eval(expr))
+
+parser = argparse.ArgumentParser(description="Generate the explicit MPC region table of the etching bath controller.")
+parser.add_argument('--bath-gain', type=float, default=config_value("HEATER_MODEL_DEFAULT_GAIN"), help="bath temperature rise over ambient per %% duty cycle in K/%% (HEATER_MODEL_DEFAULT_GAIN)")
+parser.add_argument('--bath-tau', type=float, default=config_value("HEATER_MODEL_DEFAULT_TAU"), help="bath time constant in s (HEATER_MODEL_DEFAULT_TAU)")
+parser.add_argument('--mat-gain', type=float, default=config_value("HEATER_MAT_GRADIENT_PER_DUTY"), help="mat temperature rise over bath per %% duty cycle in K/%% (HEATER_MAT_GRADIENT_PER_DUTY), the firmware uses the config.h value")
+parser.add_argument('--mat-tau', type=float, default=config_value("HEATER_MAT_TAU"), help="mat time constant in s (HEATER_MAT_TAU)")
+parser.add_argument('--set-points', type=float, nargs=3, default=[30.0, 60.0, 4], help="first and last design set point in degC and number of tables")
+parser.add_argument('--ambient', type=float, default=20.0, help="design ambient temperature in degC")
+parser.add_argument('--mat-max', type=float, default=config_value("HEATER_MAX_OPERATING_TEMP"), help="mat temperature limit in degC (HEATER_MAX_OPERATING_TEMP)")
+parser.add_argument('--interval', type=float, default=15.0, help="mpc sample time in s")
+parser.add_argument('--horizon', type=int, default=24, help="prediction horizon in samples")
+parser.add_argument('--blocks', type=int, default=4, help="number of input blocks (move blocking) over the horizon")
+parser.add_argument('--q', type=float, default=1.0, help="weight of the bath error")
+parser.add_argument('--r', type=float, default=0.002, help="weight of the duty cycle deviation")
+parser.add_argument('--bath-range', type=float, nargs=2, default=[-24.0, 8.0], help="grid range of the bath error in K")
+parser.add_argument('--mat-range', type=float, nargs=2, default=[-40.0, 110.0], help="grid range of the mat deviation in K, has to cover the mat limit of every set point")
+parser.add_argument('--cells', type=int, nargs=2, default=[16, 15], help="grid cells along bath error and mat deviation")
+parser.add_argument('--samples', type=int, default=4, help="samples per cell and axis for the affine fit")
+parser.add_argument('-o', '--output-dir', default=firmware_dir, help="directory of the generated files")
+args = parser.parse_args()
+
+# ----------------------------------------- model -----------------------------------------------
+def model_step(x, u, dt):
+    m_dev = x[1] - x[0] # mat lead over bath (deviation)
+    dx2 = (args.mat_gain * u - m_dev) / args.mat_tau
+    dx1 = ((args.bath_gain / args.mat_gain) * m_dev - x[0]) / args.bath_tau
+    return [x[0] + dx1 * dt, x[1] + dx2 * dt]
+
+def discretize():
+    # euler with small sub steps, columns of A and B
+    sub_steps = 1000
+    dt = args.interval / sub_steps
+    def run(x, u):
+        for i in range(sub_steps):
+            x = model_step(x, u, dt)
+        return x
+    a0 = run([1.0, 0.0], 0.0)
+    a1 = run([0.0, 1.0], 0.0)
+    b = run([0.0, 0.0], 1.0)
+    return [[a0[0], a1[0]], [a0[1], a1[1]]], b
+
+A, B = discretize()
+
+def mat_vec(M, v):
+    return [sum(M[i][j] * v[j] for j in range(len(v))) for i in range(len(M))]
+
+# prediction: x_k = Phi_k x0 + sum_j Gamma_kj u_j for k = 1..N, u_j piecewise constant blocks
+N = args.horizon
+NB = args.blocks
+block_of_step = [min(k * NB // N, NB - 1) for k in range(N)]
+Phi = []    # per step: 2x2
+Gamma = []    # per step: 2 x NB
+P = [[1.0, 0.0], [0.0, 1.0]]
+G = [[0.0] * NB, [0.0] * NB]
+for k in range(N):
+    # x_{k+1} = A x_k + B u_k
+    P = [[sum(A[i][l] * P[l][j] for l in range(2)) for j in range(2)] for i in range(2)]
+    G = [[sum(A[i][l] * G[l][j] for l in range(2)) for j in range(NB)] for i in range(2)]
+    for i in range(2):
+        G[i][block_of_step[k]] += B[i]
+    Phi.append(P)
+    Gamma.append(G)
+
+# ----------------------------------------- QP --------------------------------------------------
+# cost: sum_k q * x1_k^2 + r * sum_k u_k^2  ->  0.5 u' H u + f' u
+block_len = [block_of_step.count(j) for j in range(NB)]
+H = [[0.0] * NB for i in range(NB)]
+for k in range(N):
+    for i in range(NB):
+        for j in range(NB):
+            H[i][j] += 2.0 * args.q * Gamma[k][0][i] * Gamma[k][0][j]
+for i in range(NB):
+    H[i][i] += 2.0 * args.r * block_len[i]
+
+def invert(M):
+    n = len(M)
+    W = [row[:] + [1.0 if i == j else 0.0 for j in range(n)] for i, row in enumerate(M)]
+    for c in range(n):
+        p = max(range(c, n), key=lambda r: abs(W[r][c]))
+        W[c], W[p] = W[p], W[c]
+        pv = W[c][c]
+        W[c] = [v / pv for v in W[c]]
+        for r in range(n):
+            if r != c:
+                f = W[r][c]
+                W[r] = [W[r][j] - f * W[c][j] for j in range(2 * n)]
+    return [row[n:] for row in W]
+
+H_inv = invert(H)
+
+# constraints C u <= d(x0): input bounds per block and mat limit per step
+C = []
+for j in range(NB):
+    C.append([1.0 if i == j else 0.0 for i in range(NB)])
+    C.append([-1.0 if i == j else 0.0 for i in range(NB)])
+for k in range(N):
+    C.append(Gamma[k][1][:])
+# dual hessian C H^-1 C'
+CHi = [mat_vec(H_inv, row) for row in C]    # rows: H^-1 c_i
+D = [[sum(C[i][l] * CHi[j][l] for l in range(NB)) for j in range(len(C))] for i in range(len(C))]
+
+def solve(x0, u_min, u_max, x2_max):
+    f = [0.0] * NB
+    for k in range(N):
+        x1_free = Phi[k][0][0] * x0[0] + Phi[k][0][1] * x0[1]
+        for i in range(NB):
+            f[i] += 2.0 * args.q * Gamma[k][0][i] * x1_free
+    d = []
+    for j in range(NB):
+        d.append(u_max)
+        d.append(-u_min)
+    for k in range(N):
+        d.append(x2_max - (Phi[k][1][0] * x0[0] + Phi[k][1][1] * x0[1]))
+    # unconstrained optimum
+    u = [-v for v in mat_vec(H_inv, f)]
+    if all(sum(C[i][l] * u[l] for l in range(NB)) <= d[i] + 1e-9 for i in range(len(C))):
+        return u
+    # hildreth's dual coordinate ascent
+    K = [d[i] - sum(C[i][l] * u[l] for l in range(NB)) for i in range(len(C))]
+    lam = [0.0] * len(C)
+    for it in range(2000):
+        change = 0.0
+        for i in range(len(C)):
+            w = -(K[i] + sum(D[i][j] * lam[j] for j in range(len(C))) - D[i][i] * lam[i]) / D[i][i]
+            w = max(w, 0.0)
+            change += abs(w - lam[i])
+            lam[i] = w
+        if change < 1e-9:
+            break
+    return [u[l] - sum(CHi[i][l] * lam[i] for i in range(len(C))) for l in range(NB)]
+
+# ----------------------------------------- fit -------------------------------------------------
+def fit_cell(x1_lo, x1_hi, x2_lo, x2_hi, limits):
+    # least squares fit of u = k0 + k1 x1 + k2 x2 over sample points of the cell (cell centered coordinates)
+    c1 = 0.5 * (x1_lo + x1_hi)
+    c2 = 0.5 * (x2_lo + x2_hi)
+    S = [[0.0] * 3 for i in range(3)]
+    t = [0.0] * 3
+    samples = []
+    n = args.samples
+    for i in range(n):
+        for j in range(n):
+            x1 = x1_lo + (x1_hi - x1_lo) * (i + 0.5) / n
+            x2 = x2_lo + (x2_hi - x2_lo) * (j + 0.5) / n
+            u = solve([x1, x2], *limits)[0]
+            phi = [1.0, x1 - c1, x2 - c2]
+            samples.append((phi, u))
+            for a in range(3):
+                t[a] += phi[a] * u
+                for b in range(3):
+                    S[a][b] += phi[a] * phi[b]
+    k = mat_vec(invert(S), t)
+    err = max(abs(sum(k[a] * phi[a] for a in range(3)) - u) for phi, u in samples)
+    return k, err
+
+n1, n2 = args.cells
+step1 = (args.bath_range[1] - args.bath_range[0]) / n1
+step2 = (args.mat_range[1] - args.mat_range[0]) / n2
+n_sp = int(args.set_points[2])
+sp_step = (args.set_points[1] - args.set_points[0]) / (n_sp - 1) if n_sp > 1 else 0.0
+tables = []
+max_err = 0.0
+for s in range(n_sp):
+    set_point = args.set_points[0] + s * sp_step
+    # steady state of the design point
+    u_ss = (set_point - args.ambient) / args.bath_gain
+    mat_ss = set_point + args.mat_gain * u_ss
+    if u_ss < 0.0 or u_ss > 100.0 or mat_ss > args.mat_max:
+        raise SystemExit("design set point %.1f degC can't be held with the given model" % set_point)
+    x2_max = args.mat_max - mat_ss
+    if x2_max > args.mat_range[1]:
+        raise SystemExit("mat range doesn't cover the mat limit of %.1f K at %.1f degC" % (x2_max, set_point))
+    limits = (-u_ss, 100.0 - u_ss, x2_max)
+    table = []
+    for i in range(n1):
+        for j in range(n2):
+            k, err = fit_cell(args.bath_range[0] + i * step1, args.bath_range[0] + (i + 1) * step1, args.mat_range[0] + j * step2, args.mat_range[0] + (j + 1) * step2, limits)
+            table.append(k)
+            max_err = max(max_err, err)
+    tables.append(table)
+    print("design point %.1f degC: u_ss = %.1f %%, mat_ss = %.1f degC, mat limit at %.1f K" % (set_point, u_ss, mat_ss, x2_max))
+print("max fit error: %.2f %% duty cycle" % max_err)
+
+# ----------------------------------------- output ----------------------------------------------
+# int16 fixed point, scales are powers of two
+def scale_for(values):
+    m = max(abs(v) for v in values)
+    s = 1
+    while m * s * 2 < 32767 and s < (1 << 14):
+        s *= 2
+    return s
+
+offset_scale = scale_for([k[0] for table in tables for k in table])
+gain_scale = scale_for([v for table in tables for k in table for v in k[1:]])
+
+with open(os.path.join(os.path.dirname(os.path.abspath(__file__)), "mpctable.py")) as f:
+    license_text = f.read().split('"""')[1].strip()
+
+header = "/*\n" + license_text + "\n */\n\n// generated by mpc_table_script/mpctable.py, do not edit\n// " + " ".join("%s=%s" % (k, v) for k, v in sorted(vars(args).items()) if k != "output_dir") + "\n"
+
+with open(os.path.join(args.output_dir, "mpc_table.h"), "w", newline="\n") as f:
+    f.write(header)
+    f.write("\n\n#ifndef MPC_TABLE_H_\n#define MPC_TABLE_H_\n#include <stdint.h>\n#include <avr/pgmspace.h>\n\n")
+    f.write("#define MPC_TABLE_SET_POINTS %d\n" % n_sp)
+    f.write("#define MPC_TABLE_SET_POINT_MIN %.3f\n" % args.set_points[0])
+    f.write("#define MPC_TABLE_SET_POINT_STEP %.3f\n" % sp_step)
+    f.write("#define MPC_TABLE_BATH_CELLS %d\n" % n1)
+    f.write("#define MPC_TABLE_MAT_CELLS %d\n" % n2)
+    f.write("#define MPC_TABLE_BATH_MIN %.3f\n" % args.bath_range[0])
+    f.write("#define MPC_TABLE_BATH_STEP %.3f\n" % step1)
+    f.write("#define MPC_TABLE_MAT_MIN %.3f\n" % args.mat_range[0])
+    f.write("#define MPC_TABLE_MAT_STEP %.3f\n" % step2)
+    f.write("#define MPC_TABLE_OFFSET_SCALE %d.0\n" % offset_scale)
+    f.write("#define MPC_TABLE_GAIN_SCALE %d.0\n" % gain_scale)
+    f.write("\n// per set point and cell (bath major): offset, bath error gain, mat deviation gain. Relative to the cell center.\n")
+    f.write("extern const int16_t mpc_table[MPC_TABLE_SET_POINTS][MPC_TABLE_BATH_CELLS * MPC_TABLE_MAT_CELLS][3] PROGMEM;\n")
+    f.write("\n#endif /* MPC_TABLE_H_ */\n")
+
+with open(os.path.join(args.output_dir, "mpc_table.c"), "w", newline="\n") as f:
+    f.write(header)
+    f.write("\n#include \"mpc_table.h\"\n\n")
+    f.write("const int16_t mpc_table[MPC_TABLE_SET_POINTS][MPC_TABLE_BATH_CELLS * MPC_TABLE_MAT_CELLS][3] PROGMEM = {\n")
+    for s, table in enumerate(tables):
+        f.write("\t{ // %.1f degC\n" % (args.set_points[0] + s * sp_step))
+        for i, k in enumerate(table):
+            f.write("\t\t{%d, %d, %d}%s\n" % (round(k[0] * offset_scale), round(k[1] * gain_scale), round(k[2] * gain_scale), "," if i < len(table) - 1 else ""))
+        f.write("\t}%s\n" % ("," if s < len(tables) - 1 else ""))
+    f.write("};\n")